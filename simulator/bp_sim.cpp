@@ -0,0 +1,135 @@
+/**
+ * bp_sim.cpp - entry point of the branch predictor simulator
+ * Replays branch trace of functional simulation through several predictors,
+ * returns and indirect jumps are predicted as in fetch stage of performance simulation.
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* Generic C. */
+#include <cstdlib>
+
+/* Generic C++ */
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/* Simulator modules. */
+#include <core/core_config.h>
+#include <core/front_end_predictor.h>
+#include <infra/config/config.h>
+#include <infra/thread_pool.h>
+#include <infra/trace/branch_trace.h>
+
+namespace config {
+    static RequiredValue<std::string> branch_trace = { "branch-trace,t", "input branch trace written by functional simulation"};
+    static Value<uint32> threads = { "threads", 0, "number of simulation threads, zero means number of hardware threads"};
+    static Value<uint32> worst = { "worst", 10, "number of the most mispredicted branches to print for each mode"};
+} // namespace config
+
+struct BranchStats
+{
+    uint64 executions = 0;
+    uint64 mispredictions = 0;
+};
+
+struct Configuration
+{
+    std::string mode;
+    std::unique_ptr<FrontEndPredictor> predictor;
+    uint64 mispredictions = 0;
+    std::unordered_map<Addr, BranchStats> branches = {};
+};
+
+static void simulate( const BranchTrace& trace, Configuration* run)
+{
+    for ( size_t i = 0; i < trace.size(); ++i)
+    {
+        const Addr PC = trace.get_PC( i);
+        const bool is_taken = trace.is_taken( i);
+        const Addr target = trace.get_target( i);
+        const uint32 raw = trace.get_raw( i);
+
+        /* there are no wrong paths in the trace, but mispredicted outcomes are undone from histories as on flush */
+        const BPPrediction prediction = run->predictor->predict( PC, raw);
+        const bool is_misprediction = prediction.is_taken != is_taken || ( is_taken && prediction.target != target);
+        run->predictor->update( PC, raw, is_taken, target);
+        if ( is_misprediction)
+            run->predictor->flush();
+
+        BranchStats& stats = run->branches[ PC];
+        ++stats.executions;
+        if ( is_misprediction)
+        {
+            ++stats.mispredictions;
+            ++run->mispredictions;
+        }
+    }
+}
+
+static void print_worst_branches( const Configuration& run, uint32 count)
+{
+    std::vector<std::pair<Addr, BranchStats>> branches( run.branches.begin(), run.branches.end());
+    std::sort( branches.begin(), branches.end(), []( const auto& a, const auto& b) {
+        return a.second.mispredictions != b.second.mispredictions
+             ? a.second.mispredictions > b.second.mispredictions
+             : a.first < b.first;
+    });
+
+    for ( size_t i = 0; i < std::min<size_t>( count, branches.size()); ++i)
+    {
+        const auto& branch = branches[ i];
+        if ( branch.second.mispredictions == 0)
+            break;
+
+        std::cout << "    0x" << std::hex << branch.first << std::dec << ": "
+                  << branch.second.mispredictions << " mispredictions of "
+                  << branch.second.executions << " executions" << std::endl;
+    }
+}
+
+int main( int argc, char** argv)
+{
+    /* Analysing and handling of inserted arguments */
+    config::handleArgs( argc, argv);
+
+    /* all the predictors are created before simulation, so wrong modes are reported at once */
+    const BPParameters params = config::bp_parameters();
+    std::vector<Configuration> configs;
+    std::istringstream modes( config::bp_mode);
+    std::string mode;
+    while ( modes >> mode)
+        configs.push_back( { mode, std::make_unique<FrontEndPredictor>( mode, params, config::ras_size)});
+
+    if ( configs.empty())
+    {
+        std::cerr << "ERROR: List of branch prediction modes is empty" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    const BranchTrace trace( config::branch_trace);
+    uint64 instructions = 0;
+    for ( size_t i = 0; i < trace.size(); ++i)
+        instructions += trace.get_instructions( i);
+
+    /* predictors are independent, each one is simulated by its own task */
+    ThreadPool pool( config::threads);
+    for ( auto& run : configs)
+        pool.submit( [&trace, &run]() { simulate( trace, &run); });
+    pool.wait();
+
+    std::cout << trace.size() << " branches, " << instructions << " instructions" << std::endl;
+    for ( const auto& run : configs)
+    {
+        const double mpki = instructions == 0 ? 0 : 1000.0 * run.mispredictions / instructions;
+        std::cout << run.mode << ": " << run.mispredictions << " mispredictions, MPKI "
+                  << mpki << std::endl;
+        print_worst_branches( run, config::worst);
+    }
+
+    return 0;
+}
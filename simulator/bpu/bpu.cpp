@@ -0,0 +1,85 @@
+/*
+ * bpu.cpp - the branch prediction unit for MIPS
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cstdlib>
+
+// generic C++
+#include <iostream>
+
+#include "bpu.h"
+#include "global_history.h"
+#include "hybrid.h"
+#include "loop.h"
+#include "perceptron.h"
+#include "tage.h"
+
+BPFactory::BPFactory() :
+    map({ { "static_always_taken",   new BPCreator<BPEntryAlwaysTaken>},
+          { "static_backward_jumps", new BPCreator<BPEntryBackwardJumps>},
+          { "dynamic_one_bit",       new BPCreator<BPEntryOneBit>},
+          { "dynamic_two_bit",       new BPCreator<BPEntryTwoBit>},
+          { "adaptive_two_level",    new BPCreator<BPEntryAdaptive<2>>},
+          { "gshare",                new PredictorCreator<GShare>},
+          { "gselect",               new PredictorCreator<GSelect>},
+          { "tage",                  new PredictorCreator<TAGE>},
+          { "perceptron",            new PredictorCreator<Perceptron>}})
+{ }
+
+BPFactory::~BPFactory()
+{
+    for ( auto& elem : map)
+        delete elem.second;
+}
+
+std::unique_ptr<BaseBP> BPFactory::create( const std::string& name, const BPParameters& params) const
+{
+    const std::string loop_prefix = "loop:";
+    if ( name.compare( 0, loop_prefix.size(), loop_prefix) == 0)
+        return std::make_unique<LoopBP>( create( name.substr( loop_prefix.size()), params), params.loop_size_in_entries);
+
+    const std::string hybrid_prefix = "hybrid:";
+    if ( name.compare( 0, hybrid_prefix.size(), hybrid_prefix) == 0)
+    {
+        const auto comma = name.find( ',', hybrid_prefix.size());
+        if ( comma == std::string::npos)
+        {
+            std::cerr << "ERROR. Hybrid branch predictor should be set as hybrid:first,second" << std::endl;
+            std::exit( EXIT_FAILURE);
+        }
+
+        return std::make_unique<Hybrid>( create( name.substr( hybrid_prefix.size(), comma - hybrid_prefix.size()), params),
+                                         create( name.substr( comma + 1), params),
+                                         params.chooser_size_in_entries);
+    }
+
+    if ( map.find(name) == map.end())
+    {
+         std::cerr << "ERROR. Invalid branch prediction mode " << name << std::endl
+                   << "Supported modes:" << std::endl;
+         for ( const auto& map_name : map)
+             std::cerr << "\t" << map_name.first << std::endl;
+         std::cerr << "\thybrid:<mode>,<mode>" << std::endl
+                   << "\tloop:<mode>" << std::endl;
+
+         std::exit( EXIT_FAILURE);
+    }
+
+    return map.at( name)->create( params);
+}
+
+std::unique_ptr<BaseBP> BPFactory::create( const std::string& name,
+                                           uint32 size_in_entries,
+                                           uint32 ways,
+                                           uint32 branch_ip_size_in_bits,
+                                           const std::string& replacement) const
+{
+    BPParameters params;
+    params.size_in_entries = size_in_entries;
+    params.ways = ways;
+    params.branch_ip_size_in_bits = branch_ip_size_in_bits;
+    params.replacement = replacement;
+    return create( name, params);
+}
@@ -8,8 +8,10 @@
  #define BRANCH_PREDICTION_UNIT
 
 // C++ generic modules
-#include <vector>
+#include <map>
 #include <memory>
+#include <string>
+#include <vector>
 
 // MIPT_MIPS modules
 #include <infra/cache/cache_tag_array.h>
@@ -23,57 +25,81 @@
  *                           BRANCH PREDICTION UNIT                            *
  *******************************************************************************
  */
+/* direction and target of a branch, not taken branch continues to the next instruction */
+struct BPPrediction
+{
+    bool is_taken = false;
+    Addr target = NO_VAL32;
+};
+
 class BaseBP
 {
 public:
-    virtual bool is_taken( Addr PC) = 0;
-    virtual Addr get_target( Addr PC) = 0;
+    /* direction and target are found by one lookup */
+    virtual BPPrediction predict( Addr PC) = 0;
     virtual void update( bool is_taken,
                          Addr branch_ip,
                          Addr target) = 0;
 
+    /*
+     * Predictors with history see the fetched branches by their predicted outcomes,
+     * history of the wrong path is repaired on flush by the one of resolved branches.
+     * Fetch group thrown away by the next stage is undone by restore of the checkpoint.
+     */
+    virtual void speculative_update( bool /* is_taken */, Addr /* branch_ip */) { }
+    virtual void flush() { }
+    virtual void checkpoint() { }
+    virtual void restore() { }
+
+    bool is_taken( Addr PC) { return predict( PC).is_taken; }
+    Addr get_target( Addr PC) { return predict( PC).target; }
+
     virtual ~BaseBP() = default;
 };
 
 template<typename T>
 class BP : public BaseBP
 {
-    std::vector<std::vector<T>> data;
+    /* entries of each set are contiguous, as the tags in CacheTagArray */
+    std::vector<T> data;
     CacheTagArray tags;
 
+    T& get_entry( Addr PC, uint32 way) { return data[ static_cast<size_t>( tags.set( PC)) * tags.ways + way]; }
+
 public:
     BP( uint32   size_in_entries,
         uint32   ways,
-        uint32 branch_ip_size_in_bits) :
+        uint32 branch_ip_size_in_bits,
+        const std::string& replacement) :
 
-        data( ways, std::vector<T>( size_in_entries / ways)),
-        tags( size_in_entries,
+        data( size_in_entries),
+        tags( size_in_entries * 4, // an entry is a 4-byte "line"
               ways,
               4,
-              branch_ip_size_in_bits)
+              branch_ip_size_in_bits,
+              replacement)
         { }
 
     /* prediction */
-    bool is_taken( Addr PC) final
+    BPPrediction predict( Addr PC) final
     {
         uint32 way;
         bool is_hit;
         std::tie( is_hit, way) = tags.read_no_touch( PC);
-        if ( is_hit) // hit
-            return data[ way][ tags.set(PC)].is_taken( PC);
-
-        return false;
-    }
 
-    Addr get_target( Addr PC) final
-    {
-        uint32 way;
-        bool is_hit;
-        std::tie( is_hit, way) = tags.read_no_touch( PC);
+        BPPrediction prediction;
         if ( is_hit) // hit
-            return data[ way][ tags.set(PC)].getTarget();
+        {
+            const T& entry = get_entry( PC, way);
+            prediction.is_taken = entry.is_taken( PC);
+            if ( prediction.is_taken)
+                prediction.target = entry.getTarget();
+        }
+
+        if ( !prediction.is_taken)
+            prediction.target = PC + 4;
 
-        return PC + 4;
+        return prediction;
     }
 
     /* update */
@@ -81,81 +107,112 @@ public:
                  Addr branch_ip,
                  Addr target) final
     {
-        uint32 set = tags.set( branch_ip);
         uint32 way;
         bool is_hit;
         std::tie( is_hit, way) = tags.read( branch_ip);
         if ( !is_hit) { // miss
             way = tags.write( branch_ip); // add new entry to cache
-            data[ way][ set].reset();
+            get_entry( branch_ip, way).reset();
         }
 
-        data[ way][ set].update( is_taken, target);
+        get_entry( branch_ip, way).update( is_taken, target);
     }
 };
 
-
 /*
  *******************************************************************************
  *                                FACTORY CLASS                                *
  *******************************************************************************
  */
+
+/* parameters of predictors, each predictor uses the relevant ones */
+struct BPParameters
+{
+    /* branch target buffer */
+    uint32 size_in_entries = 128;
+    uint32 ways = 16;
+    uint32 branch_ip_size_in_bits = 32;
+    std::string replacement = "lru";
+
+    /* global history predictors */
+    uint32 history_length = 8;
+    uint32 pht_size_in_entries = 4096;
+
+    /* TAGE, bimodal table has pht_size_in_entries counters */
+    uint32 tage_tables = 4;
+    uint32 tage_table_size = 1024;
+    uint32 tage_min_history = 5;
+    uint32 tage_max_history = 130;
+    uint32 tage_min_tag_bits = 8;
+    uint32 tage_max_tag_bits = 12;
+
+    /* perceptron */
+    uint32 perceptron_history_length = 32;
+    uint32 perceptron_table_size = 256;
+
+    /* hybrid:first,second */
+    uint32 chooser_size_in_entries = 4096;
+
+    /* loop:base */
+    uint32 loop_size_in_entries = 64;
+
+    /* target predictor of indirect jumps */
+    uint32 ittage_tables = 4;
+    uint32 ittage_table_size = 512;
+    uint32 ittage_min_history = 4;
+    uint32 ittage_max_history = 64;
+    uint32 ittage_tag_bits = 10;
+};
+
 class BPFactory {
     class BaseBPCreator {
     public:
-        virtual std::unique_ptr<BaseBP> create(uint32 size_in_entries,
-                                               uint32 ways,
-                                               uint32 branch_ip_size_in_bits) const = 0;
+        virtual std::unique_ptr<BaseBP> create( const BPParameters& params) const = 0;
         virtual ~BaseBPCreator() = default;
     };
 
+    /* predictors with entries in BTB */
     template<typename T>
     class BPCreator : public BaseBPCreator {
     public:
-        std::unique_ptr<BaseBP> create(uint32 size_in_entries,
-                                       uint32 ways,
-                                       uint32 branch_ip_size_in_bits) const final
+        std::unique_ptr<BaseBP> create( const BPParameters& params) const final
+        {
+            return std::make_unique<BP<T>>( params.size_in_entries,
+                                            params.ways,
+                                            params.branch_ip_size_in_bits,
+                                            params.replacement);
+        }
+    };
+
+    /* predictors with their own tables */
+    template<typename T>
+    class PredictorCreator : public BaseBPCreator {
+    public:
+        std::unique_ptr<BaseBP> create( const BPParameters& params) const final
         {
-            return std::make_unique<BP<T>>( size_in_entries,
-                                            ways,
-                                            branch_ip_size_in_bits);
+            return std::make_unique<T>( params);
         }
     };
 
     const std::map<std::string, BaseBPCreator*> map;
 
 public:
-    BPFactory() :
-        map({ { "static_always_taken",   new BPCreator<BPEntryAlwaysTaken>},
-              { "static_backward_jumps", new BPCreator<BPEntryBackwardJumps>},
-              { "dynamic_one_bit",       new BPCreator<BPEntryOneBit>},
-              { "dynamic_two_bit",       new BPCreator<BPEntryTwoBit>},
-              { "adaptive_two_level",    new BPCreator<BPEntryAdaptive<2>>}})
-    { }
+    BPFactory();
+    ~BPFactory();
+
+    /* forbid copies */
+    BPFactory& operator=( const BPFactory&) = delete;
+    BPFactory( const BPFactory&) = delete;
+
+    /* "hybrid:first,second" makes a tournament of two predictors,
+     * "loop:base" attaches loop predictor to the base one */
+    std::unique_ptr<BaseBP> create( const std::string& name, const BPParameters& params) const;
 
     std::unique_ptr<BaseBP> create( const std::string& name,
                     uint32 size_in_entries,
                     uint32 ways,
-                    uint32 branch_ip_size_in_bits = 32) const
-    {
-        if ( map.find(name) == map.end())
-        {
-             std::cerr << "ERROR. Invalid branch prediction mode " << name << std::endl
-                       << "Supported modes:" << std::endl;
-             for ( const auto& map_name : map)
-                 std::cerr << "\t" << map_name.first << std::endl;
-
-             std::exit( EXIT_FAILURE);
-        }
-
-        return map.at( name)->create( size_in_entries, ways, branch_ip_size_in_bits);
-    }
-
-    ~BPFactory()
-    {
-        for ( auto& elem : map)
-            delete elem.second;
-    }
+                    uint32 branch_ip_size_in_bits = 32,
+                    const std::string& replacement = "lru") const;
 };
 
 #endif
@@ -0,0 +1,93 @@
+/*
+ * btb.h - branch target buffer for predictors with their own direction tables
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef BRANCH_TARGET_BUFFER
+#define BRANCH_TARGET_BUFFER
+
+// C++ generic modules
+#include <string>
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/cache/cache_tag_array.h>
+#include <infra/types.h>
+
+#include "bpu.h"
+
+/* keeps the last target of each taken branch, an entry is a 4-byte "line" of the tag array */
+class BTB
+{
+    CacheTagArray tags;
+    std::vector<Addr> targets;
+
+public:
+    BTB( uint32 size_in_entries,
+         uint32 ways,
+         uint32 branch_ip_size_in_bits,
+         const std::string& replacement)
+        : tags( size_in_entries * 4, ways, 4, branch_ip_size_in_bits, replacement)
+        , targets( size_in_entries, NO_VAL32)
+    { }
+
+    /* NO_VAL32 if the branch was never taken */
+    Addr get_target( Addr PC) const
+    {
+        uint32 way;
+        bool is_hit;
+        std::tie( is_hit, way) = tags.read_no_touch( PC);
+        if ( !is_hit)
+            return NO_VAL32;
+
+        return targets[ tags.set( PC) * tags.ways + way];
+    }
+
+    void update( bool is_taken, Addr PC, Addr target)
+    {
+        uint32 way;
+        bool is_hit;
+        std::tie( is_hit, way) = tags.read( PC);
+        if ( !is_hit && !is_taken) // not taken branches do not need targets
+            return;
+
+        if ( !is_hit)
+            way = tags.write( PC);
+
+        if ( is_taken)
+            targets[ tags.set( PC) * tags.ways + way] = target;
+    }
+};
+
+/*
+ * Base of the predictors with their own direction tables: they predict directions only,
+ * targets of taken branches come from BTB.
+ */
+class DirectionBP : public BaseBP
+{
+    BTB btb;
+
+    virtual bool predict_direction( Addr PC) const = 0;
+    virtual void update_direction( bool is_taken, Addr branch_ip) = 0;
+
+public:
+    explicit DirectionBP( const BPParameters& params)
+        : btb( params.size_in_entries, params.ways, params.branch_ip_size_in_bits, params.replacement)
+    { }
+
+    BPPrediction predict( Addr PC) final
+    {
+        /* branches without target in BTB are predicted not taken */
+        const Addr target = btb.get_target( PC);
+        const bool is_taken = target != NO_VAL32 && predict_direction( PC);
+        return { is_taken, is_taken ? target : PC + 4};
+    }
+
+    void update( bool is_taken, Addr branch_ip, Addr target) final
+    {
+        update_direction( is_taken, branch_ip);
+        btb.update( is_taken, branch_ip, target);
+    }
+};
+
+#endif
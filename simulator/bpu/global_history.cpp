@@ -0,0 +1,106 @@
+/*
+ * global_history.cpp - branch predictors with global history
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cstdlib>
+
+// generic C++
+#include <iostream>
+
+// MIPT_MIPS modules
+#include <infra/macro.h>
+
+#include "global_history.h"
+
+GlobalHistory::GlobalHistory( uint32 length) : length( length)
+{
+    if ( length == 0 || length > 64)
+    {
+        std::cerr << "ERROR. Length of global history should be from 1 to 64 bits" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+uint64 GlobalHistory::fold( uint32 bits) const
+{
+    if ( bits == 0)
+        return 0;
+
+    const uint64 mask = bits >= 64 ? ~uint64{ 0} : ( uint64{ 1} << bits) - 1;
+    uint64 result = 0;
+    for ( uint32 i = 0; i < length; i += bits)
+        result ^= ( value >> i) & mask;
+
+    return result;
+}
+
+void GlobalHistory::update( bool is_taken)
+{
+    value = ( value << 1) | ( is_taken ? 1 : 0);
+    if ( length < 64)
+        value &= ( uint64{ 1} << length) - 1;
+}
+
+void BranchHistory::update( bool is_taken)
+{
+    head = ( head + bits.size() - 1) % bits.size();
+    bits[ head] = is_taken ? 1 : 0;
+}
+
+FoldedHistory::FoldedHistory( uint32 original_length, uint32 compressed_length)
+    : original_length( original_length)
+    , compressed_length( compressed_length)
+{ }
+
+void FoldedHistory::update( const BranchHistory& history)
+{
+    /* shift the latest outcome in and the outcome leaving the window out */
+    value = ( value << 1) | history.get( 0);
+    value ^= history.get( original_length) << ( original_length % compressed_length);
+    value ^= value >> compressed_length;
+    value &= ( 1u << compressed_length) - 1;
+}
+
+GlobalHistoryBP::GlobalHistoryBP( const BPParameters& params, bool is_concatenation)
+    : DirectionBP( params)
+    , pht( params.pht_size_in_entries)
+    , index_bits( log_bin( params.pht_size_in_entries))
+    , history( GlobalHistory( params.history_length))
+    , is_concatenation( is_concatenation)
+{
+    if ( params.pht_size_in_entries == 0 || !is_power_of_two( params.pht_size_in_entries))
+    {
+        std::cerr << "ERROR. Size of pattern history table should be a power of 2" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( is_concatenation && params.history_length >= index_bits)
+    {
+        std::cerr << "ERROR. Global history of gselect should be shorter than index of pattern history table" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+size_t GlobalHistoryBP::get_index( Addr PC, const GlobalHistory& outcomes) const
+{
+    const uint64 mask = ( uint64{ 1} << index_bits) - 1;
+    const uint64 address = PC >> 2;
+
+    if ( is_concatenation)
+        return static_cast<size_t>( ( ( address << outcomes.get_length()) | outcomes.get_value()) & mask);
+
+    return static_cast<size_t>( ( address ^ outcomes.fold( index_bits)) & mask);
+}
+
+bool GlobalHistoryBP::predict_direction( Addr PC) const
+{
+    return pht[ get_index( PC, history.fetched)].is_taken();
+}
+
+void GlobalHistoryBP::update_direction( bool is_taken, Addr branch_ip)
+{
+    pht[ get_index( branch_ip, history.resolved)].update( is_taken);
+    history.resolved.update( is_taken);
+}
@@ -0,0 +1,107 @@
+/*
+ * global_history.h - branch predictors with global history
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef GLOBAL_HISTORY_BP
+#define GLOBAL_HISTORY_BP
+
+// C++ generic modules
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "btb.h"
+#include "speculative.h"
+
+/* outcomes of the last branches, the latest one is in the lowest bit */
+class GlobalHistory
+{
+    uint32 length;
+    uint64 value = 0;
+
+public:
+    explicit GlobalHistory( uint32 length);
+
+    uint32 get_length() const { return length; }
+    uint64 get_value() const { return value; }
+
+    /* history compressed to "bits" bits by xor of its chunks */
+    uint64 fold( uint32 bits) const;
+
+    void update( bool is_taken);
+};
+
+/* outcomes of the last branches, longer than a machine word */
+class BranchHistory
+{
+    std::vector<uint8> bits;
+    size_t head = 0;
+
+public:
+    explicit BranchHistory( uint32 length) : bits( length + 1, 0) { }
+
+    /* zero is the latest outcome */
+    uint32 get( uint32 position) const { return bits[ ( head + position) % bits.size()]; }
+    void update( bool is_taken);
+};
+
+/* history of "original_length" bits xored into "compressed_length" bits, updated incrementally */
+class FoldedHistory
+{
+    uint32 original_length;
+    uint32 compressed_length;
+    uint32 value = 0;
+
+public:
+    FoldedHistory( uint32 original_length, uint32 compressed_length);
+
+    uint32 get_value() const { return value; }
+
+    /* called after the history is updated */
+    void update( const BranchHistory& history);
+};
+
+/*
+ * Two-level predictor: pattern history table of two-bit counters
+ * is indexed by the branch address together with the global history.
+ * Fetched branches shift their predicted outcomes into the history,
+ * so the branches in flight are included.
+ */
+class GlobalHistoryBP : public DirectionBP
+{
+    std::vector<BPEntryTwoBit::State> pht;
+    const uint32 index_bits;
+    SpeculativeState<GlobalHistory> history;
+
+    /* gshare hashes address and history by xor, gselect concatenates them */
+    const bool is_concatenation;
+
+    size_t get_index( Addr PC, const GlobalHistory& outcomes) const;
+
+    bool predict_direction( Addr PC) const final;
+    void update_direction( bool is_taken, Addr branch_ip) final;
+
+public:
+    GlobalHistoryBP( const BPParameters& params, bool is_concatenation);
+
+    void speculative_update( bool is_taken, Addr /* branch_ip */) final { history.fetched.update( is_taken); }
+    void flush() final { history.flush(); }
+    void checkpoint() final { history.checkpoint(); }
+    void restore() final { history.restore(); }
+};
+
+class GShare final : public GlobalHistoryBP
+{
+public:
+    explicit GShare( const BPParameters& params) : GlobalHistoryBP( params, false) { }
+};
+
+class GSelect final : public GlobalHistoryBP
+{
+public:
+    explicit GSelect( const BPParameters& params) : GlobalHistoryBP( params, true) { }
+};
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ * hybrid.cpp - tournament of two branch predictors
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cstdlib>
+
+// generic C++
+#include <iostream>
+#include <tuple>
+#include <utility>
+
+// MIPT_MIPS modules
+#include <infra/macro.h>
+
+#include "hybrid.h"
+
+Hybrid::Hybrid( std::unique_ptr<BaseBP> first, std::unique_ptr<BaseBP> second, uint32 chooser_size_in_entries)
+    : first( std::move( first))
+    , second( std::move( second))
+    , chooser( chooser_size_in_entries)
+    , predictions()
+{
+    if ( chooser_size_in_entries == 0 || !is_power_of_two( chooser_size_in_entries))
+    {
+        std::cerr << "ERROR. Size of hybrid predictor chooser should be a power of 2" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+BaseBP* Hybrid::get_chosen( Addr PC)
+{
+    return chooser[ ( PC >> 2) & ( chooser.size() - 1)].is_taken() ? second.get() : first.get();
+}
+
+BPPrediction Hybrid::predict( Addr PC)
+{
+    return get_chosen( PC)->predict( PC);
+}
+
+void Hybrid::update( bool is_taken, Addr branch_ip, Addr target)
+{
+    bool first_prediction;
+    bool second_prediction;
+    std::tie( first_prediction, second_prediction) = predictions.pop();
+    if ( first_prediction != second_prediction)
+        chooser[ ( branch_ip >> 2) & ( chooser.size() - 1)].update( second_prediction == is_taken);
+
+    first->update( is_taken, branch_ip, target);
+    second->update( is_taken, branch_ip, target);
+}
+
+void Hybrid::speculative_update( bool is_taken, Addr branch_ip)
+{
+    predictions.push( { first->is_taken( branch_ip), second->is_taken( branch_ip)});
+    first->speculative_update( is_taken, branch_ip);
+    second->speculative_update( is_taken, branch_ip);
+}
+
+void Hybrid::flush()
+{
+    predictions.flush();
+    first->flush();
+    second->flush();
+}
+
+void Hybrid::checkpoint()
+{
+    predictions.checkpoint();
+    first->checkpoint();
+    second->checkpoint();
+}
+
+void Hybrid::restore()
+{
+    predictions.restore();
+    first->restore();
+    second->restore();
+}
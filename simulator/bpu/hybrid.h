@@ -0,0 +1,48 @@
+/*
+ * hybrid.h - tournament of two branch predictors
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef HYBRID_BP
+#define HYBRID_BP
+
+// C++ generic modules
+#include <memory>
+#include <utility>
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "bpu.h"
+#include "speculative.h"
+
+/*
+ * Chooser table of two-bit counters selects one of two predictors for each branch.
+ * A counter is trained only when the predictors disagree at fetch,
+ * 'taken' state means that the second predictor is chosen.
+ */
+class Hybrid final : public BaseBP
+{
+    std::unique_ptr<BaseBP> first;
+    std::unique_ptr<BaseBP> second;
+    std::vector<BPEntryTwoBit::State> chooser;
+
+    /* predictions of the first and the second predictor for each fetched branch */
+    InFlightQueue<std::pair<bool, bool>> predictions;
+
+    BaseBP* get_chosen( Addr PC);
+
+public:
+    Hybrid( std::unique_ptr<BaseBP> first, std::unique_ptr<BaseBP> second, uint32 chooser_size_in_entries);
+
+    BPPrediction predict( Addr PC) final;
+    void update( bool is_taken, Addr branch_ip, Addr target) final;
+
+    void speculative_update( bool is_taken, Addr branch_ip) final;
+    void flush() final;
+    void checkpoint() final;
+    void restore() final;
+};
+
+#endif
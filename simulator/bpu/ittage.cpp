@@ -0,0 +1,172 @@
+/*
+ * ittage.cpp - target predictor of indirect jumps
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cmath>
+#include <cstdlib>
+
+// generic C++
+#include <algorithm>
+#include <iostream>
+
+// MIPT_MIPS modules
+#include <infra/macro.h>
+
+#include "ittage.h"
+
+static void check_parameters( const BPParameters& params)
+{
+    if ( params.ittage_tables > 16)
+    {
+        std::cerr << "ERROR. Number of indirect predictor tagged tables should be from 0 to 16" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.ittage_table_size < 2 || !is_power_of_two( params.ittage_table_size))
+    {
+        std::cerr << "ERROR. Size of indirect predictor tables should be a power of 2" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.ittage_min_history == 0 || params.ittage_min_history > params.ittage_max_history)
+    {
+        std::cerr << "ERROR. Indirect predictor history lengths should satisfy 0 < min <= max" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.ittage_tag_bits == 0 || params.ittage_tag_bits > 16)
+    {
+        std::cerr << "ERROR. Indirect predictor tag width should be from 1 to 16" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+ITTAGE::Table::Table( uint32 index_bits, uint32 tag_bits)
+    : entries( 1u << index_bits)
+    , tag_bits( tag_bits)
+{ }
+
+ITTAGE::ITTAGE( const BPParameters& params)
+    : base( params.ittage_table_size, NO_VAL32)
+    , tables()
+    , index_bits( log_bin( params.ittage_table_size))
+    , history( History( params.ittage_max_history))
+{
+    check_parameters( params);
+
+    /* history lengths form a geometric series */
+    History initial( params.ittage_max_history);
+    const double ratio = static_cast<double>( params.ittage_max_history) / params.ittage_min_history;
+    for ( uint32 i = 0; i < params.ittage_tables; ++i)
+    {
+        const double power = params.ittage_tables == 1 ? 0. : static_cast<double>( i) / ( params.ittage_tables - 1);
+        const auto history_length = static_cast<uint32>( std::lround( params.ittage_min_history * std::pow( ratio, power)));
+        tables.emplace_back( index_bits, params.ittage_tag_bits);
+        initial.index.emplace_back( history_length, index_bits);
+        initial.tag.emplace_back( history_length, params.ittage_tag_bits);
+    }
+    history = SpeculativeState<History>( initial);
+}
+
+size_t ITTAGE::get_index( Addr PC, size_t table, const History& path) const
+{
+    const uint32 address = PC >> 2;
+    const uint32 hash = address ^ ( address >> ( index_bits - table % index_bits)) ^ path.index[ table].get_value();
+    return hash & ( tables[ table].entries.size() - 1);
+}
+
+uint16 ITTAGE::get_tag( Addr PC, size_t table, const History& path) const
+{
+    return static_cast<uint16>( ( ( PC >> 2) ^ path.tag[ table].get_value()) & ( ( 1u << tables[ table].tag_bits) - 1));
+}
+
+size_t ITTAGE::get_provider( Addr PC, const History& path) const
+{
+    for ( size_t i = tables.size(); i-- > 0;)
+    {
+        const Entry& entry = tables[ i].entries[ get_index( PC, i, path)];
+        if ( entry.target != NO_VAL32 && entry.tag == get_tag( PC, i, path))
+            return i;
+    }
+
+    return NO_TABLE;
+}
+
+Addr ITTAGE::get_target( Addr PC, const History& path) const
+{
+    const size_t provider = get_provider( PC, path);
+    if ( provider == NO_TABLE)
+        return base[ ( PC >> 2) & ( base.size() - 1)];
+
+    return tables[ provider].entries[ get_index( PC, provider, path)].target;
+}
+
+Addr ITTAGE::get_target( Addr PC) const
+{
+    return get_target( PC, history.fetched);
+}
+
+void ITTAGE::update( Addr PC, Addr target)
+{
+    /* resolved jumps have the path the jump has been predicted with */
+    const History& path = history.resolved;
+    const Addr prediction = get_target( PC, path);
+    const size_t provider = get_provider( PC, path);
+
+    if ( provider != NO_TABLE)
+    {
+        Entry& entry = tables[ provider].entries[ get_index( PC, provider, path)];
+        if ( entry.target == target)
+        {
+            entry.confidence = std::min<uint8>( entry.confidence + 1, 3);
+            entry.useful = 1;
+        }
+        else if ( entry.confidence > 0)
+        {
+            --entry.confidence;
+        }
+        else
+        {
+            entry.target = target;
+        }
+    }
+
+    base[ ( PC >> 2) & ( base.size() - 1)] = target;
+
+    if ( prediction == target)
+        return;
+
+    /* misprediction allocates an entry with a longer history */
+    const size_t first_table = provider == NO_TABLE ? 0 : provider + 1;
+    for ( size_t i = first_table; i < tables.size(); ++i)
+    {
+        Entry& entry = tables[ i].entries[ get_index( PC, i, path)];
+        if ( entry.useful == 0)
+        {
+            entry.target = target;
+            entry.tag = get_tag( PC, i, path);
+            entry.confidence = 0;
+            return;
+        }
+    }
+
+    /* no room, the entries may be replaced next time */
+    for ( size_t i = first_table; i < tables.size(); ++i)
+        tables[ i].entries[ get_index( PC, i, path)].useful = 0;
+}
+
+void ITTAGE::History::update( Addr target)
+{
+    /* two bits of each target are shifted into the path */
+    for ( uint32 bit = 2; bit < 4; ++bit)
+    {
+        path.update( ( ( target >> bit) & 1) != 0);
+        for ( size_t i = 0; i < index.size(); ++i)
+        {
+            index[ i].update( path);
+            tag[ i].update( path);
+        }
+    }
+}
@@ -0,0 +1,86 @@
+/*
+ * ittage.h - target predictor of indirect jumps
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef ITTAGE_BP
+#define ITTAGE_BP
+
+// C++ generic modules
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "bpu.h"
+#include "global_history.h"
+#include "speculative.h"
+
+/*
+ * Indirect jumps have several targets, so the last target of a jump
+ * is backed by tagged tables indexed by the jump address hashed with
+ * path histories (target bits of the taken branches) of geometrically growing lengths.
+ * The target comes from the hitting table with the longest history.
+ */
+class ITTAGE
+{
+    struct Entry
+    {
+        Addr target = NO_VAL32;
+        uint16 tag = 0;
+        uint8 confidence = 0; // 2-bit
+        uint8 useful = 0;     // 1-bit
+    };
+
+    struct Table
+    {
+        std::vector<Entry> entries;
+        uint32 tag_bits;
+
+        Table( uint32 index_bits, uint32 tag_bits);
+    };
+
+    /* target bits of taken branches and their foldings for each table */
+    struct History
+    {
+        BranchHistory path;
+        std::vector<FoldedHistory> index;
+        std::vector<FoldedHistory> tag;
+
+        explicit History( uint32 length) : path( length), index(), tag() { }
+        void update( Addr target);
+    };
+
+    static const size_t NO_TABLE = SIZE_MAX;
+
+    /* last targets, indexed by address only */
+    std::vector<Addr> base;
+    std::vector<Table> tables;
+    const uint32 index_bits;
+    SpeculativeState<History> history;
+
+    size_t get_index( Addr PC, size_t table, const History& path) const;
+    uint16 get_tag( Addr PC, size_t table, const History& path) const;
+    size_t get_provider( Addr PC, const History& path) const;
+    Addr get_target( Addr PC, const History& path) const;
+
+public:
+    explicit ITTAGE( const BPParameters& params);
+
+    /* NO_VAL32 if the jump was never seen */
+    Addr get_target( Addr PC) const;
+
+    /* called for each resolved indirect jump */
+    void update( Addr PC, Addr target);
+
+    /* called for each resolved taken branch */
+    void update_path( Addr target) { history.resolved.update( target); }
+
+    /* fetched taken branches change the path as resolved ones, the wrong path is repaired on flush */
+    void speculative_update_path( Addr target) { history.fetched.update( target); }
+    void flush() { history.flush(); }
+    void checkpoint() { history.checkpoint(); }
+    void restore() { history.restore(); }
+};
+
+#endif
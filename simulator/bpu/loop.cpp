@@ -0,0 +1,180 @@
+/*
+ * loop.cpp - loop predictor attached to another branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cstdlib>
+
+// generic C++
+#include <algorithm>
+#include <iostream>
+#include <utility>
+
+// MIPT_MIPS modules
+#include <infra/macro.h>
+
+#include "loop.h"
+
+LoopBP::LoopBP( std::unique_ptr<BaseBP> base, uint32 size_in_entries)
+    : base( std::move( base))
+    , entries( size_in_entries)
+    , index_bits( log_bin( size_in_entries))
+    , iterations( std::vector<uint16>( size_in_entries, 0))
+    , base_predictions()
+{
+    if ( size_in_entries == 0 || !is_power_of_two( size_in_entries))
+    {
+        std::cerr << "ERROR. Size of loop predictor should be a power of 2" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+size_t LoopBP::get_index( Addr PC) const
+{
+    return ( PC >> 2) & ( entries.size() - 1);
+}
+
+uint16 LoopBP::get_tag( Addr PC) const
+{
+    return static_cast<uint16>( PC >> ( 2 + index_bits));
+}
+
+const LoopBP::Entry* LoopBP::get_confident_entry( Addr PC) const
+{
+    const Entry& entry = entries[ get_index( PC)];
+    if ( entry.is_valid && entry.tag == get_tag( PC) && entry.confidence == MAX_CONFIDENCE)
+        return &entry;
+
+    return nullptr;
+}
+
+bool LoopBP::get_prediction( const Entry& entry, uint16 iteration)
+{
+    return iteration == entry.trip_count ? !entry.direction : entry.direction;
+}
+
+BPPrediction LoopBP::predict( Addr PC)
+{
+    const Entry* entry = get_confident_entry( PC);
+    if ( entry == nullptr)
+        return base->predict( PC);
+
+    const bool is_taken = get_prediction( *entry, iterations.fetched[ get_index( PC)]) && entry->target != NO_VAL32;
+    return { is_taken, is_taken ? entry->target : PC + 4};
+}
+
+void LoopBP::speculative_update( bool is_taken, Addr branch_ip)
+{
+    base_predictions.push( base->is_taken( branch_ip));
+    base->speculative_update( is_taken, branch_ip);
+
+    const size_t index = get_index( branch_ip);
+    const Entry& entry = entries[ index];
+    if ( !entry.is_valid || entry.tag != get_tag( branch_ip))
+        return;
+
+    uint16& iteration = iterations.fetched[ index];
+    if ( is_taken != entry.direction)
+        iteration = 0;
+    else if ( iteration < UINT16_MAX)
+        ++iteration;
+}
+
+void LoopBP::flush()
+{
+    iterations.flush();
+    base_predictions.flush();
+    base->flush();
+}
+
+void LoopBP::checkpoint()
+{
+    iterations.checkpoint();
+    base_predictions.checkpoint();
+    base->checkpoint();
+}
+
+void LoopBP::restore()
+{
+    iterations.restore();
+    base_predictions.restore();
+    base->restore();
+}
+
+void LoopBP::update( bool is_taken, Addr branch_ip, Addr target)
+{
+    const bool base_prediction = base_predictions.pop();
+    base->update( is_taken, branch_ip, target);
+
+    const size_t index = get_index( branch_ip);
+    Entry& entry = entries[ index];
+    uint16& iteration = iterations.resolved[ index];
+    if ( !entry.is_valid || entry.tag != get_tag( branch_ip))
+    {
+        if ( base_prediction == is_taken)
+            return;
+
+        /* entries of other loops are replaced after several chances */
+        if ( entry.is_valid && entry.age > 0)
+        {
+            --entry.age;
+            return;
+        }
+
+        /* the mispredicted outcome is supposed to be an exit */
+        entry = Entry();
+        entry.is_valid = true;
+        entry.tag = get_tag( branch_ip);
+        entry.direction = !is_taken;
+        entry.age = MAX_AGE;
+
+        /* the next iterations in flight are not counted, a misprediction of the exit repairs the count */
+        iteration = 0;
+        iterations.fetched[ index] = 0;
+        return;
+    }
+
+    if ( is_taken)
+        entry.target = target;
+
+    if ( entry.confidence == MAX_CONFIDENCE && get_prediction( entry, iteration) == is_taken && base_prediction != is_taken)
+        entry.age = std::min<uint8>( entry.age + 1, MAX_AGE);
+
+    if ( is_taken == entry.direction)
+    {
+        if ( iteration == UINT16_MAX) // too long for a counted loop
+        {
+            entry.is_valid = false;
+            return;
+        }
+
+        ++iteration;
+        if ( iteration > entry.trip_count)
+            entry.confidence = 0;
+        return;
+    }
+
+    /* the allocating misprediction was not an exit, if the outcome repeats */
+    if ( iteration == 0 && entry.confidence < MAX_CONFIDENCE)
+    {
+        entry.direction = is_taken;
+        entry.trip_count = 0;
+        entry.confidence = 0;
+        iteration = 1;
+        iterations.fetched[ index] = 1;
+        return;
+    }
+
+    /* exit of the loop */
+    if ( iteration == entry.trip_count)
+    {
+        entry.confidence = std::min<uint8>( entry.confidence + 1, MAX_CONFIDENCE);
+    }
+    else
+    {
+        entry.trip_count = iteration;
+        entry.confidence = 0;
+    }
+    iteration = 0;
+}
@@ -0,0 +1,71 @@
+/*
+ * loop.h - loop predictor attached to another branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef LOOP_BP
+#define LOOP_BP
+
+// C++ generic modules
+#include <memory>
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "bpu.h"
+#include "speculative.h"
+
+/*
+ * Counted loops repeat one outcome of a branch the same number of times
+ * before the opposite one. Once the trip count is confirmed several times,
+ * the loop predictor overrides the base predictor, so the exit is predicted too.
+ * Entries are allocated for branches mispredicted by the base predictor.
+ * Iterations are counted by fetched branches too, so the exit is predicted
+ * while the previous iterations are in flight.
+ */
+class LoopBP final : public BaseBP
+{
+    struct Entry
+    {
+        uint16 tag = 0;
+        bool is_valid = false;
+        bool direction = false;     // the repeated outcome
+        uint16 trip_count = 0;      // repeated outcomes before the exit
+        uint8 confidence = 0;
+        uint8 age = 0;
+        Addr target = NO_VAL32;
+    };
+
+    static const uint8 MAX_CONFIDENCE = 3;
+    static const uint8 MAX_AGE = 3;
+
+    std::unique_ptr<BaseBP> base;
+    std::vector<Entry> entries;
+    const uint32 index_bits;
+
+    /* repeated outcomes of each entry since the last exit */
+    SpeculativeState<std::vector<uint16>> iterations;
+
+    /* predictions of the base predictor for each fetched branch */
+    InFlightQueue<bool> base_predictions;
+
+    size_t get_index( Addr PC) const;
+    uint16 get_tag( Addr PC) const;
+    /* entry which overrides the base predictor, nullptr if there is none */
+    const Entry* get_confident_entry( Addr PC) const;
+    static bool get_prediction( const Entry& entry, uint16 iteration);
+
+public:
+    LoopBP( std::unique_ptr<BaseBP> base, uint32 size_in_entries);
+
+    BPPrediction predict( Addr PC) final;
+    void update( bool is_taken, Addr branch_ip, Addr target) final;
+
+    void speculative_update( bool is_taken, Addr branch_ip) final;
+    void flush() final;
+    void checkpoint() final;
+    void restore() final;
+};
+
+#endif
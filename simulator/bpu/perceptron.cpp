@@ -0,0 +1,157 @@
+/*
+ * perceptron.cpp - perceptron branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cstdlib>
+
+// generic C++
+#include <algorithm>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+#include "perceptron.h"
+
+/* sum of products of 8-bit weights and inputs, "count" is a multiple of 32 */
+static int32 dot_product( const int8* weights, const int8* inputs, uint32 count)
+{
+    uint32 i = 0;
+    int32 result = 0;
+#if defined(__AVX2__)
+    __m256i sum8 = _mm256_setzero_si256();
+    for ( ; i + 16 <= count; i += 16)
+    {
+        const __m256i w = _mm256_cvtepi8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( weights + i)));
+        const __m256i x = _mm256_cvtepi8_epi16( _mm_loadu_si128( reinterpret_cast<const __m128i*>( inputs + i)));
+        sum8 = _mm256_add_epi32( sum8, _mm256_madd_epi16( w, x));
+    }
+    const __m128i sum4 = _mm_add_epi32( _mm256_castsi256_si128( sum8), _mm256_extracti128_si256( sum8, 1));
+    alignas( 16) int32 parts[ 4];
+    _mm_store_si128( reinterpret_cast<__m128i*>( parts), sum4);
+    result += parts[ 0] + parts[ 1] + parts[ 2] + parts[ 3];
+#elif defined(__SSE2__) || defined(_M_X64)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sum4 = _mm_setzero_si128();
+    for ( ; i + 16 <= count; i += 16)
+    {
+        const __m128i w = _mm_loadu_si128( reinterpret_cast<const __m128i*>( weights + i));
+        const __m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( inputs + i));
+        /* sign extension of bytes to 16-bit words */
+        const __m128i w_sign = _mm_cmpgt_epi8( zero, w);
+        const __m128i x_sign = _mm_cmpgt_epi8( zero, x);
+        sum4 = _mm_add_epi32( sum4, _mm_madd_epi16( _mm_unpacklo_epi8( w, w_sign), _mm_unpacklo_epi8( x, x_sign)));
+        sum4 = _mm_add_epi32( sum4, _mm_madd_epi16( _mm_unpackhi_epi8( w, w_sign), _mm_unpackhi_epi8( x, x_sign)));
+    }
+    alignas( 16) int32 parts[ 4];
+    _mm_store_si128( reinterpret_cast<__m128i*>( parts), sum4);
+    result += parts[ 0] + parts[ 1] + parts[ 2] + parts[ 3];
+#endif
+    for ( ; i < count; ++i)
+        result += weights[ i] * inputs[ i];
+
+    return result;
+}
+
+/* adds inputs to weights (or subtracts them) with saturation */
+static void train( int8* weights, const int8* inputs, uint32 count, bool is_taken)
+{
+    uint32 i = 0;
+#if defined(__AVX2__)
+    for ( ; i + 32 <= count; i += 32)
+    {
+        auto w_ptr = reinterpret_cast<__m256i*>( weights + i);
+        const __m256i x = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( inputs + i));
+        const __m256i w = _mm256_loadu_si256( w_ptr);
+        _mm256_storeu_si256( w_ptr, is_taken ? _mm256_adds_epi8( w, x) : _mm256_subs_epi8( w, x));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    for ( ; i + 16 <= count; i += 16)
+    {
+        auto w_ptr = reinterpret_cast<__m128i*>( weights + i);
+        const __m128i x = _mm_loadu_si128( reinterpret_cast<const __m128i*>( inputs + i));
+        const __m128i w = _mm_loadu_si128( w_ptr);
+        _mm_storeu_si128( w_ptr, is_taken ? _mm_adds_epi8( w, x) : _mm_subs_epi8( w, x));
+    }
+#endif
+    for ( ; i < count; ++i)
+    {
+        const int32 value = is_taken ? weights[ i] + inputs[ i] : weights[ i] - inputs[ i];
+        weights[ i] = static_cast<int8>( std::min( std::max( value, -128), 127));
+    }
+}
+
+/* not taken outcomes at start, padding stays zero */
+static std::vector<int8> get_initial_history( uint32 length, uint32 stride)
+{
+    std::vector<int8> history( stride, 0);
+    std::fill_n( history.begin(), length, -1);
+    return history;
+}
+
+static void shift_history( std::vector<int8>* history, uint32 length, bool is_taken)
+{
+    std::copy_backward( history->begin(), history->begin() + length - 1, history->begin() + length);
+    ( *history)[ 0] = is_taken ? 1 : -1;
+}
+
+Perceptron::Perceptron( const BPParameters& params)
+    : DirectionBP( params)
+    , history_length( params.perceptron_history_length)
+    , stride( ( params.perceptron_history_length + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT)
+    /* the best threshold found by Jimenez and Lin */
+    , threshold( static_cast<int32>( 1.93 * params.perceptron_history_length + 14))
+    , bias( params.perceptron_table_size, 0)
+    , weights( static_cast<size_t>( params.perceptron_table_size) * stride, 0)
+    , history( get_initial_history( history_length, stride))
+{
+    if ( params.perceptron_table_size == 0)
+    {
+        std::cerr << "ERROR. Perceptron table should not be empty" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( history_length == 0 || history_length > 1024)
+    {
+        std::cerr << "ERROR. Perceptron history length should be from 1 to 1024" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+size_t Perceptron::get_index( Addr PC) const
+{
+    return ( PC >> 2) % bias.size();
+}
+
+int32 Perceptron::get_output( Addr PC, const std::vector<int8>& inputs) const
+{
+    const size_t index = get_index( PC);
+    return bias[ index] + dot_product( &weights[ index * stride], inputs.data(), stride);
+}
+
+bool Perceptron::predict_direction( Addr PC) const
+{
+    return get_output( PC, history.fetched) >= 0;
+}
+
+void Perceptron::update_direction( bool is_taken, Addr branch_ip)
+{
+    const int32 output = get_output( branch_ip, history.resolved);
+    if ( ( output >= 0) != is_taken || std::abs( output) <= threshold)
+    {
+        const size_t index = get_index( branch_ip);
+        bias[ index] = static_cast<int8>( std::min( std::max( bias[ index] + ( is_taken ? 1 : -1), -128), 127));
+        train( &weights[ index * stride], history.resolved.data(), stride, is_taken);
+    }
+
+    shift_history( &history.resolved, history_length, is_taken);
+}
+
+void Perceptron::speculative_update( bool is_taken, Addr /* branch_ip */)
+{
+    shift_history( &history.fetched, history_length, is_taken);
+}
@@ -0,0 +1,52 @@
+/*
+ * perceptron.h - perceptron branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef PERCEPTRON_BP
+#define PERCEPTRON_BP
+
+// C++ generic modules
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "btb.h"
+#include "speculative.h"
+
+/*
+ * Each branch address selects a vector of weights, the prediction is
+ * the sign of its dot product with the global history (+1 for taken, -1 for not taken).
+ * Weights are trained on mispredictions and on outputs below the threshold.
+ */
+class Perceptron final : public DirectionBP
+{
+    /* weights and inputs are padded with zeros to the width of SIMD registers */
+    static const uint32 ALIGNMENT = 32;
+
+    const uint32 history_length;
+    const uint32 stride;
+    const int32 threshold;
+
+    std::vector<int8> bias;
+    std::vector<int8> weights;
+    /* the latest outcome is the first one */
+    SpeculativeState<std::vector<int8>> history;
+
+    size_t get_index( Addr PC) const;
+    int32 get_output( Addr PC, const std::vector<int8>& inputs) const;
+
+    bool predict_direction( Addr PC) const final;
+    void update_direction( bool is_taken, Addr branch_ip) final;
+
+public:
+    explicit Perceptron( const BPParameters& params);
+
+    void speculative_update( bool is_taken, Addr /* branch_ip */) final;
+    void flush() final { history.flush(); }
+    void checkpoint() final { history.checkpoint(); }
+    void restore() final { history.restore(); }
+};
+
+#endif
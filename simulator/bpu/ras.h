@@ -0,0 +1,54 @@
+/*
+ * ras.h - return address stack
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef RETURN_ADDRESS_STACK
+#define RETURN_ADDRESS_STACK
+
+// C++ generic modules
+#include <algorithm>
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+/*
+ * Circular stack of return addresses, the oldest address is overwritten
+ * when the stack is full. Speculative stack of fetch is repaired
+ * by copying the stack updated by resolved instructions.
+ */
+class ReturnAddressStack
+{
+    std::vector<Addr> entries;
+    size_t top = 0; // position of the next push
+    size_t count = 0;
+
+public:
+    explicit ReturnAddressStack( uint32 depth) : entries( depth, NO_VAL32) { }
+
+    bool empty() const { return count == 0; }
+
+    void push( Addr address)
+    {
+        if ( entries.empty())
+            return;
+
+        entries[ top] = address;
+        top = ( top + 1) % entries.size();
+        count = std::min( count + 1, entries.size());
+    }
+
+    /* NO_VAL32 if the stack is empty */
+    Addr pop()
+    {
+        if ( empty())
+            return NO_VAL32;
+
+        top = ( top + entries.size() - 1) % entries.size();
+        --count;
+        return entries[ top];
+    }
+};
+
+#endif
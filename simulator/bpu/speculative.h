@@ -0,0 +1,73 @@
+/*
+ * speculative.h - state of predictors changed by the branches in flight
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef SPECULATIVE_BP
+#define SPECULATIVE_BP
+
+// C++ generic modules
+#include <deque>
+
+/*
+ * Fetched branches change their copy of state by the predicted outcomes,
+ * resolved branches change their copy by the actual ones. Branches are resolved
+ * in program order, so a branch is trained by the same state it has been
+ * predicted by, unless it is on the wrong path and is thrown away by a flush.
+ */
+template<typename T>
+class SpeculativeState
+{
+    T group; // fetched state before the last fetch group
+
+public:
+    T fetched;
+    T resolved;
+
+    explicit SpeculativeState( const T& initial) : group( initial), fetched( initial), resolved( initial) { }
+
+    /* changes of the wrong path are undone */
+    void flush() { fetched = resolved; }
+
+    /* fetch group thrown away by the next stage is fetched again */
+    void checkpoint() { group = fetched; }
+    void restore() { fetched = group; }
+};
+
+/* data kept by each fetched branch until it is resolved */
+template<typename T>
+class InFlightQueue
+{
+    std::deque<T> queue = {};
+    size_t group_size = 0; // entries of the last fetch group
+
+public:
+    void push( const T& value)
+    {
+        queue.push_back( value);
+        ++group_size;
+    }
+
+    /* the oldest branch is resolved */
+    T pop()
+    {
+        const T value = queue.front();
+        queue.pop_front();
+        return value;
+    }
+
+    void flush()
+    {
+        queue.clear();
+        group_size = 0;
+    }
+
+    void checkpoint() { group_size = 0; }
+    void restore()
+    {
+        queue.erase( queue.end() - group_size, queue.end());
+        group_size = 0;
+    }
+};
+
+#endif
@@ -1,13 +1,31 @@
 // generic C
 #include <cassert>
 #include <cstdlib>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
 
 // Google Test library
 #include <gtest/gtest.h>
 
 // MIPT-MIPS modules
 #include "../bpu.h"
+#include "../btb.h"
+#include "../ittage.h"
+#include "../ras.h"
 
+// branch is fetched and resolved at once, as in branch trace simulation
+static BPPrediction predict_and_update( BaseBP* bp, bool is_taken, Addr PC, Addr target)
+{
+    const BPPrediction prediction = bp->predict( PC);
+    bp->speculative_update( prediction.is_taken, PC);
+    bp->update( is_taken, PC, target);
+    if ( prediction.is_taken != is_taken || ( is_taken && prediction.target != target))
+        bp->flush();
+
+    return prediction;
+}
 
 TEST( Initialization, WrongParameters)
 {
@@ -116,6 +134,437 @@ TEST( Overload, LRU)
     ASSERT_EQ( bp->get_target(PCconst), target);
 }
 
+TEST( Overload, Full_Capacity)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( "dynamic_two_bit", 128, 16);
+
+    for ( Addr i = 0; i < 128; ++i)
+        bp->update( true, 0x400000 + 4 * i, 0x500000 + 4 * i);
+
+    for ( Addr i = 0; i < 128; ++i)
+        ASSERT_EQ( bp->get_target( 0x400000 + 4 * i), 0x500000 + 4 * i);
+}
+
+TEST( Overload, Pseudo_LRU)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( "dynamic_two_bit", 128, 16, 32, "plru");
+
+    const Addr PCconst = 16;
+    Addr target = 48;
+
+    // entry which is used often is kept
+    for ( int i = 0; i < 1000; i++)
+    {
+        bp->update( false, i, NO_VAL32);
+        bp->update( true, PCconst, target);
+    }
+
+    ASSERT_EQ( bp->is_taken(PCconst), 1);
+    ASSERT_EQ( bp->get_target(PCconst), target);
+
+    ASSERT_EXIT( bp_factory.create( "dynamic_two_bit", 128, 16, 32, "mru"), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( BTB, Full_Capacity)
+{
+    BTB btb( 128, 16, 32, "lru");
+
+    // each of 8 sets gets 16 branches
+    for ( Addr i = 0; i < 128; ++i)
+        btb.update( true, 0x400000 + 4 * i, 0x500000 + 4 * i);
+
+    for ( Addr i = 0; i < 128; ++i)
+        ASSERT_EQ( btb.get_target( 0x400000 + 4 * i), 0x500000 + 4 * i);
+
+    ASSERT_EQ( btb.get_target( 0x400000 + 4 * 128), NO_VAL32);
+}
+
+static uint32 alternating_mispredictions( const std::string& mode)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+    params.history_length = 4;
+    params.pht_size_in_entries = 256;
+    auto bp = bp_factory.create( mode, params);
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400200;
+
+    // branch is taken every second time, the last outcomes are counted
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 200; ++i)
+    {
+        bool is_taken = ( i % 2) == 0;
+        if ( predict_and_update( bp.get(), is_taken, PC, target).is_taken != is_taken && i >= 100)
+            ++mispredictions;
+    }
+    return mispredictions;
+}
+
+TEST( GlobalHistory, Alternating_Pattern)
+{
+    ASSERT_EQ( alternating_mispredictions( "gshare"), 0u);
+    ASSERT_EQ( alternating_mispredictions( "gselect"), 0u);
+    ASSERT_GT( alternating_mispredictions( "dynamic_two_bit"), 0u);
+}
+
+TEST( GlobalHistory, Target)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( "gshare", BPParameters());
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400200;
+
+    // not taken branches continue to the next instruction
+    ASSERT_EQ( bp->is_taken( PC), 0);
+    ASSERT_EQ( bp->get_target( PC), PC + 4);
+
+    for ( uint32 i = 0; i < 20; ++i)
+        predict_and_update( bp.get(), true, PC, target);
+
+    ASSERT_EQ( bp->is_taken( PC), 1);
+    ASSERT_EQ( bp->get_target( PC), target);
+}
+
+TEST( GlobalHistory, WrongParameters)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+
+    params.pht_size_in_entries = 1000;
+    ASSERT_EXIT( bp_factory.create( "gshare", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.pht_size_in_entries = 256;
+    params.history_length = 8;
+    ASSERT_EXIT( bp_factory.create( "gselect", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.history_length = 0;
+    ASSERT_EXIT( bp_factory.create( "gshare", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+// branches are fetched "depth" branches ahead of resolution, a misprediction flushes the younger ones
+static uint32 pipelined_mispredictions( const std::string& mode, uint32 depth, uint32 period = 2)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+    params.history_length = 4;
+    params.pht_size_in_entries = 256;
+    auto bp = bp_factory.create( mode, params);
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400200;
+
+    // the branch is not taken once a period, fetched index and prediction are kept till resolution
+    std::deque<std::pair<uint32, bool>> in_flight;
+    uint32 fetched = 0;
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 100 * period; ++i)
+    {
+        while ( in_flight.size() < depth)
+        {
+            const bool prediction = bp->is_taken( PC);
+            bp->speculative_update( prediction, PC);
+            in_flight.emplace_back( fetched++, prediction);
+        }
+
+        const uint32 index = in_flight.front().first;
+        const bool prediction = in_flight.front().second;
+        in_flight.pop_front();
+
+        const bool is_taken = ( index % period) != period - 1;
+        bp->update( is_taken, PC, target);
+        if ( prediction != is_taken)
+        {
+            bp->flush();
+            in_flight.clear();
+            fetched = index + 1;
+            if ( i >= 50 * period)
+                ++mispredictions;
+        }
+    }
+    return mispredictions;
+}
+
+TEST( GlobalHistory, Branches_In_Flight)
+{
+    for ( const auto& mode : { "gshare", "gselect", "tage", "perceptron"})
+    {
+        ASSERT_EQ( pipelined_mispredictions( mode, 2), 0u) << mode;
+        ASSERT_EQ( pipelined_mispredictions( mode, 5), 0u) << mode;
+    }
+}
+
+TEST( GlobalHistory, Fetch_Group_Restored)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( "gshare", BPParameters());
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400200;
+
+    // the branch is taken every second time
+    for ( uint32 i = 0; i < 100; ++i)
+        predict_and_update( bp.get(), ( i % 2) == 0, PC, target);
+
+    // the next one is predicted by the fetched one, before it is resolved
+    const bool prediction = bp->is_taken( PC);
+    bp->checkpoint();
+    bp->speculative_update( prediction, PC);
+    ASSERT_NE( bp->is_taken( PC), prediction);
+
+    // the group is fetched again
+    bp->restore();
+    ASSERT_EQ( bp->is_taken( PC), prediction);
+}
+
+TEST( TAGE, Long_Pattern)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( "tage", BPParameters());
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400200;
+
+    // loop of 20 iterations needs history longer than gshare one
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 2000; ++i)
+    {
+        bool is_taken = ( i % 20) != 19;
+        if ( predict_and_update( bp.get(), is_taken, PC, target).is_taken != is_taken && i >= 1000)
+            ++mispredictions;
+    }
+    ASSERT_EQ( mispredictions, 0u);
+    ASSERT_EQ( alternating_mispredictions( "tage"), 0u);
+}
+
+TEST( TAGE, WrongParameters)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+
+    params.tage_tables = 0;
+    ASSERT_EXIT( bp_factory.create( "tage", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.tage_tables = 4;
+    params.tage_table_size = 1000;
+    ASSERT_EXIT( bp_factory.create( "tage", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.tage_table_size = 1024;
+    params.tage_min_history = 200;
+    ASSERT_EXIT( bp_factory.create( "tage", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.tage_min_history = 4;
+    params.tage_max_tag_bits = 20;
+    ASSERT_EXIT( bp_factory.create( "tage", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( Perceptron, Long_History)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+    params.perceptron_history_length = 40;
+    auto bp = bp_factory.create( "perceptron", params);
+
+    const Addr PC = 0x400100;
+    const Addr other_PC = 0x400300;
+    const Addr target = 0x400200;
+
+    // the branch repeats outcome of a branch executed 33 branches before
+    std::mt19937 random( 5489);
+    std::vector<bool> outcomes;
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 20000; ++i)
+    {
+        bool is_taken = random() % 2 == 0;
+        if ( i % 34 == 33)
+        {
+            is_taken = outcomes[ i - 33];
+            if ( predict_and_update( bp.get(), is_taken, PC, target).is_taken != is_taken && i >= 10000)
+                ++mispredictions;
+        }
+        else
+        {
+            predict_and_update( bp.get(), is_taken, other_PC + ( i % 34) * 4, target);
+        }
+        outcomes.push_back( is_taken);
+    }
+    ASSERT_LT( mispredictions, 5u);
+}
+
+TEST( Perceptron, WrongParameters)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+
+    params.perceptron_table_size = 0;
+    ASSERT_EXIT( bp_factory.create( "perceptron", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.perceptron_table_size = 256;
+    params.perceptron_history_length = 0;
+    ASSERT_EXIT( bp_factory.create( "perceptron", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( Hybrid, Chooses_Better_Predictor)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+    params.history_length = 4;
+    params.pht_size_in_entries = 256;
+
+    const Addr alternating_PC = 0x400100;
+    const Addr backward_PC = 0x400300;
+    const Addr alternating_target = 0x400200;
+    const Addr backward_target = 0x400000;
+
+    // the first branch needs history, the second one is always taken backwards
+    for ( const auto& mode : { "hybrid:gshare,static_backward_jumps", "hybrid:static_backward_jumps,gshare"})
+    {
+        auto bp = bp_factory.create( mode, params);
+        uint32 mispredictions = 0;
+        for ( uint32 i = 0; i < 200; ++i)
+        {
+            bool is_taken = ( i % 2) == 0;
+            if ( predict_and_update( bp.get(), is_taken, alternating_PC, alternating_target).is_taken != is_taken && i >= 100)
+                ++mispredictions;
+
+            if ( !predict_and_update( bp.get(), true, backward_PC, backward_target).is_taken && i >= 100)
+                ++mispredictions;
+        }
+        ASSERT_EQ( mispredictions, 0u);
+        ASSERT_EQ( bp->get_target( backward_PC), backward_target);
+    }
+}
+
+TEST( Hybrid, WrongParameters)
+{
+    BPFactory bp_factory;
+    BPParameters params;
+
+    ASSERT_EXIT( bp_factory.create( "hybrid:gshare", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( bp_factory.create( "hybrid:gshare,two_bit", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.chooser_size_in_entries = 1000;
+    ASSERT_EXIT( bp_factory.create( "hybrid:gshare,dynamic_two_bit", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( RAS, Push_And_Pop)
+{
+    ReturnAddressStack ras( 2);
+    ASSERT_TRUE( ras.empty());
+    ASSERT_EQ( ras.pop(), NO_VAL32);
+
+    ras.push( 0x100);
+    ras.push( 0x200);
+    ras.push( 0x300); // overwrites the oldest one
+
+    ASSERT_EQ( ras.pop(), 0x300u);
+    ASSERT_EQ( ras.pop(), 0x200u);
+    ASSERT_TRUE( ras.empty());
+
+    // repair by the copy of another stack
+    ReturnAddressStack committed( 2);
+    committed.push( 0x400);
+    ras.push( 0x500);
+    ras = committed;
+    ASSERT_EQ( ras.pop(), 0x400u);
+
+    ReturnAddressStack disabled( 0);
+    disabled.push( 0x100);
+    ASSERT_TRUE( disabled.empty());
+}
+
+static uint32 loop_exit_mispredictions( const std::string& mode)
+{
+    BPFactory bp_factory;
+    auto bp = bp_factory.create( mode, BPParameters());
+
+    const Addr PC = 0x400100;
+    const Addr target = 0x400080;
+
+    // backward branch of loop with 10 iterations
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 300; ++i)
+    {
+        bool is_taken = ( i % 10) != 9;
+        if ( predict_and_update( bp.get(), is_taken, PC, target).target != ( is_taken ? target : PC + 4) && i >= 100)
+            ++mispredictions;
+    }
+    return mispredictions;
+}
+
+TEST( Loop, Exit)
+{
+    ASSERT_EQ( loop_exit_mispredictions( "loop:dynamic_two_bit"), 0u);
+    ASSERT_EQ( loop_exit_mispredictions( "loop:gshare"), 0u);
+    ASSERT_GE( loop_exit_mispredictions( "gshare"), 20u); // each exit at least
+
+    // the exit is predicted while the previous iterations are in flight
+    ASSERT_EQ( pipelined_mispredictions( "loop:dynamic_two_bit", 4, 10), 0u);
+    ASSERT_EQ( pipelined_mispredictions( "loop:gshare", 4, 10), 0u);
+
+    BPFactory bp_factory;
+    BPParameters params;
+    params.loop_size_in_entries = 48;
+    ASSERT_EXIT( bp_factory.create( "loop:gshare", params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+static uint32 dispatch_mispredictions( uint32 tables)
+{
+    BPParameters params;
+    params.ittage_tables = tables;
+    ITTAGE bp( params);
+
+    // dispatch jump of interpreter goes to handlers in turn
+    const Addr PC = 0x400100;
+    const std::vector<Addr> handlers = { 0x400010, 0x400024, 0x400038};
+
+    uint32 mispredictions = 0;
+    for ( uint32 i = 0; i < 300; ++i)
+    {
+        const Addr target = handlers[ i % handlers.size()];
+        const Addr prediction = bp.get_target( PC);
+        bp.speculative_update_path( prediction);
+        bp.update( PC, target);
+        bp.update_path( target);
+        if ( prediction != target)
+        {
+            bp.flush();
+            if ( i >= 150)
+                ++mispredictions;
+        }
+    }
+    return mispredictions;
+}
+
+TEST( ITTAGE, Several_Targets)
+{
+    ASSERT_EQ( dispatch_mispredictions( 4), 0u);
+    // the last target only
+    ASSERT_EQ( dispatch_mispredictions( 0), 150u);
+
+    BPParameters params;
+    ASSERT_EQ( ITTAGE( params).get_target( 0x400100), NO_VAL32);
+}
+
+TEST( ITTAGE, WrongParameters)
+{
+    BPParameters params;
+
+    params.ittage_table_size = 1000;
+    ASSERT_EXIT( ITTAGE bp( params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.ittage_table_size = 512;
+    params.ittage_min_history = 0;
+    ASSERT_EXIT( ITTAGE bp( params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    params.ittage_min_history = 4;
+    params.ittage_tag_bits = 0;
+    ASSERT_EXIT( ITTAGE bp( params), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
 int main( int argc, char* argv[])
 {
     ::testing::InitGoogleTest( &argc, argv);
@@ -0,0 +1,231 @@
+/*
+ * tage.cpp - TAgged GEometric history length branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+// generic C
+#include <cmath>
+#include <cstdlib>
+
+// generic C++
+#include <algorithm>
+#include <iostream>
+
+// MIPT_MIPS modules
+#include <infra/macro.h>
+
+#include "tage.h"
+
+static void check_parameters( const BPParameters& params)
+{
+    if ( params.tage_tables == 0 || params.tage_tables > 16)
+    {
+        std::cerr << "ERROR. Number of TAGE tagged tables should be from 1 to 16" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.tage_table_size < 2 || !is_power_of_two( params.tage_table_size)
+      || params.pht_size_in_entries == 0 || !is_power_of_two( params.pht_size_in_entries))
+    {
+        std::cerr << "ERROR. Sizes of TAGE tables should be powers of 2" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.tage_min_history == 0 || params.tage_min_history > params.tage_max_history)
+    {
+        std::cerr << "ERROR. TAGE history lengths should satisfy 0 < min <= max" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( params.tage_min_tag_bits < 2 || params.tage_min_tag_bits > params.tage_max_tag_bits
+      || params.tage_max_tag_bits > 16)
+    {
+        std::cerr << "ERROR. TAGE tag widths should satisfy 2 <= min <= max <= 16" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+}
+
+TAGE::Table::Table( uint32 index_bits, uint32 history_length, uint32 tag_bits)
+    : entries( 1u << index_bits)
+    , history_length( history_length)
+    , tag_bits( tag_bits)
+{ }
+
+TAGE::TAGE( const BPParameters& params)
+    : DirectionBP( params)
+    , bimodal( params.pht_size_in_entries)
+    , tables()
+    , index_bits( log_bin( params.tage_table_size))
+    , history( History( params.tage_max_history))
+{
+    check_parameters( params);
+
+    /* history lengths form a geometric series, tag widths grow linearly */
+    History initial( params.tage_max_history);
+    const uint32 last = params.tage_tables - 1;
+    const double ratio = static_cast<double>( params.tage_max_history) / params.tage_min_history;
+    for ( uint32 i = 0; i <= last; ++i)
+    {
+        const double power = last == 0 ? 0. : static_cast<double>( i) / last;
+        const auto history_length = static_cast<uint32>( std::lround( params.tage_min_history * std::pow( ratio, power)));
+        const uint32 tag_bits = last == 0 ? params.tage_min_tag_bits
+            : params.tage_min_tag_bits + ( params.tage_max_tag_bits - params.tage_min_tag_bits) * i / last;
+        tables.emplace_back( index_bits, history_length, tag_bits);
+        initial.index.emplace_back( history_length, index_bits);
+        initial.tag.emplace_back( history_length, tag_bits);
+        initial.tag_shifted.emplace_back( history_length, tag_bits - 1);
+    }
+    history = SpeculativeState<History>( initial);
+}
+
+size_t TAGE::get_bimodal_index( Addr PC) const
+{
+    return ( PC >> 2) & ( bimodal.size() - 1);
+}
+
+size_t TAGE::get_index( Addr PC, size_t table, const History& outcomes) const
+{
+    const uint32 address = PC >> 2;
+    const uint32 hash = address ^ ( address >> ( index_bits - table % index_bits)) ^ outcomes.index[ table].get_value();
+    return hash & ( tables[ table].entries.size() - 1);
+}
+
+uint16 TAGE::get_tag( Addr PC, size_t table, const History& outcomes) const
+{
+    const uint32 hash = ( PC >> 2) ^ outcomes.tag[ table].get_value() ^ ( outcomes.tag_shifted[ table].get_value() << 1);
+    return static_cast<uint16>( hash & ( ( 1u << tables[ table].tag_bits) - 1));
+}
+
+TAGE::Lookup TAGE::lookup( Addr PC, const History& outcomes) const
+{
+    Lookup result;
+    for ( size_t i = tables.size(); i-- > 0;)
+    {
+        if ( tables[ i].entries[ get_index( PC, i, outcomes)].tag != get_tag( PC, i, outcomes))
+            continue;
+
+        if ( result.provider == Lookup::NO_TABLE)
+        {
+            result.provider = i;
+        }
+        else
+        {
+            result.alternate = i;
+            break;
+        }
+    }
+
+    const bool bimodal_prediction = bimodal[ get_bimodal_index( PC)].is_taken();
+    if ( result.provider == Lookup::NO_TABLE)
+    {
+        result.provider_prediction = result.alternate_prediction = result.prediction = bimodal_prediction;
+        return result;
+    }
+
+    const Entry& provider = tables[ result.provider].entries[ get_index( PC, result.provider, outcomes)];
+    result.provider_prediction = provider.counter >= 0;
+    result.alternate_prediction = result.alternate == Lookup::NO_TABLE
+        ? bimodal_prediction
+        : tables[ result.alternate].entries[ get_index( PC, result.alternate, outcomes)].counter >= 0;
+
+    const bool is_new = ( provider.counter == 0 || provider.counter == -1) && provider.useful == 0;
+    result.prediction = is_new && use_alternate >= 0 ? result.alternate_prediction : result.provider_prediction;
+    return result;
+}
+
+bool TAGE::predict_direction( Addr PC) const
+{
+    return lookup( PC, history.fetched).prediction;
+}
+
+static void update_counter( int8* counter, bool is_taken)
+{
+    if ( is_taken)
+        *counter = std::min<int8>( *counter + 1, 3);
+    else
+        *counter = std::max<int8>( *counter - 1, -4);
+}
+
+void TAGE::allocate( Addr PC, size_t first_table, bool is_taken)
+{
+    for ( size_t i = first_table; i < tables.size(); ++i)
+    {
+        Entry& entry = tables[ i].entries[ get_index( PC, i, history.resolved)];
+        if ( entry.useful == 0)
+        {
+            entry.tag = get_tag( PC, i, history.resolved);
+            entry.counter = is_taken ? 0 : -1;
+            return;
+        }
+    }
+
+    /* no room, make the entries older to allocate them next time */
+    for ( size_t i = first_table; i < tables.size(); ++i)
+        --tables[ i].entries[ get_index( PC, i, history.resolved)].useful;
+}
+
+void TAGE::History::update( bool is_taken)
+{
+    outcomes.update( is_taken);
+    for ( size_t i = 0; i < index.size(); ++i)
+    {
+        index[ i].update( outcomes);
+        tag[ i].update( outcomes);
+        tag_shifted[ i].update( outcomes);
+    }
+}
+
+void TAGE::update_direction( bool is_taken, Addr branch_ip)
+{
+    /* resolved branches have the history the branch has been predicted with */
+    const Lookup result = lookup( branch_ip, history.resolved);
+
+    if ( result.provider == Lookup::NO_TABLE)
+    {
+        bimodal[ get_bimodal_index( branch_ip)].update( is_taken);
+    }
+    else
+    {
+        Entry& provider = tables[ result.provider].entries[ get_index( branch_ip, result.provider, history.resolved)];
+        const bool is_new = ( provider.counter == 0 || provider.counter == -1) && provider.useful == 0;
+        if ( is_new && result.provider_prediction != result.alternate_prediction)
+        {
+            use_alternate += result.alternate_prediction == is_taken ? 1 : -1;
+            use_alternate = std::min( std::max( use_alternate, -8), 7);
+        }
+
+        /* newly allocated entry is not trusted yet, so the alternate prediction is trained too */
+        if ( is_new)
+        {
+            if ( result.alternate == Lookup::NO_TABLE)
+                bimodal[ get_bimodal_index( branch_ip)].update( is_taken);
+            else
+                update_counter( &tables[ result.alternate].entries[ get_index( branch_ip, result.alternate, history.resolved)].counter, is_taken);
+        }
+
+        update_counter( &provider.counter, is_taken);
+
+        if ( result.provider_prediction != result.alternate_prediction)
+        {
+            if ( result.provider_prediction == is_taken)
+                provider.useful = std::min<uint8>( provider.useful + 1, 3);
+            else if ( provider.useful > 0)
+                --provider.useful;
+        }
+    }
+
+    if ( result.prediction != is_taken)
+    {
+        const size_t first_table = result.provider == Lookup::NO_TABLE ? 0 : result.provider + 1;
+        if ( first_table < tables.size())
+            allocate( branch_ip, first_table, is_taken);
+    }
+
+    /* entries which were useful long ago are released gradually */
+    if ( ( ++updates & ( ( 1u << 18) - 1)) == 0)
+        for ( auto& table : tables)
+            for ( auto& entry : table.entries)
+                entry.useful >>= 1;
+
+    history.resolved.update( is_taken);
+}
@@ -0,0 +1,94 @@
+/*
+ * tage.h - TAgged GEometric history length branch predictor
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef TAGE_BP
+#define TAGE_BP
+
+// C++ generic modules
+#include <vector>
+
+// MIPT_MIPS modules
+#include <infra/types.h>
+
+#include "btb.h"
+#include "global_history.h"
+#include "speculative.h"
+
+/*
+ * Bimodal table is backed by several tagged tables indexed by the branch address
+ * hashed with global histories of geometrically increasing lengths.
+ * The prediction comes from the hitting table with the longest history,
+ * a misprediction allocates an entry in a table with a longer history.
+ */
+class TAGE final : public DirectionBP
+{
+    struct Entry
+    {
+        int8 counter = 0;  // 3-bit signed, non-negative values are 'taken'
+        uint16 tag = 0;
+        uint8 useful = 0;  // 2-bit
+    };
+
+    struct Table
+    {
+        std::vector<Entry> entries;
+        uint32 history_length;
+        uint32 tag_bits;
+
+        Table( uint32 index_bits, uint32 history_length, uint32 tag_bits);
+    };
+
+    /* outcomes of branches and their foldings for each table */
+    struct History
+    {
+        BranchHistory outcomes;
+        std::vector<FoldedHistory> index;
+        std::vector<FoldedHistory> tag;
+        std::vector<FoldedHistory> tag_shifted;
+
+        explicit History( uint32 length) : outcomes( length), index(), tag(), tag_shifted() { }
+        void update( bool is_taken);
+    };
+
+    /* tables which have provided the prediction and the alternate one, NO_TABLE is the bimodal one */
+    struct Lookup
+    {
+        static const size_t NO_TABLE = SIZE_MAX;
+        size_t provider = NO_TABLE;
+        size_t alternate = NO_TABLE;
+        bool provider_prediction = false;
+        bool alternate_prediction = false;
+        bool prediction = false;
+    };
+
+    std::vector<BPEntryTwoBit::State> bimodal;
+    std::vector<Table> tables;
+    const uint32 index_bits;
+    SpeculativeState<History> history;
+
+    /* chooses alternate prediction when provider entry is newly allocated */
+    int32 use_alternate = 0;
+    uint32 updates = 0;
+
+    size_t get_bimodal_index( Addr PC) const;
+    size_t get_index( Addr PC, size_t table, const History& outcomes) const;
+    uint16 get_tag( Addr PC, size_t table, const History& outcomes) const;
+    Lookup lookup( Addr PC, const History& outcomes) const;
+
+    void allocate( Addr PC, size_t first_table, bool is_taken);
+
+    bool predict_direction( Addr PC) const final;
+    void update_direction( bool is_taken, Addr branch_ip) final;
+
+public:
+    explicit TAGE( const BPParameters& params);
+
+    void speculative_update( bool is_taken, Addr /* branch_ip */) final { history.fetched.update( is_taken); }
+    void flush() final { history.flush(); }
+    void checkpoint() final { history.checkpoint(); }
+    void restore() final { history.restore(); }
+};
+
+#endif
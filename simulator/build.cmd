@@ -6,20 +6,45 @@ rem Pavel Kryukov
 rem Clean up
 del *.obj
 
-rem Build object files
-cl /I. /EHsc /c /nologo /MD ^
+rem Common options and sources
+set FLAGS=/I. /EHsc /c /nologo /MD ^
    /D__LIBELF_INTERNAL__=1 ^
    /D_HAS_AUTO_PTR_ETC=1 ^
    /W4 /WX /wd4505 /wd4244 /wd4996 /wd4267 ^
-   /std:c++17 ^
-   infra/elf_parser/elf_parser.cpp ^
+   /std:c++17
+
+set SOURCES=infra/elf_parser/elf_parser.cpp ^
    infra/memory/memory.cpp ^
    infra/config/config.cpp ^
+   infra/log.cpp ^
    infra/ports/ports.cpp ^
+   infra/thread_pool.cpp ^
    infra/cache/cache_tag_array.cpp ^
+   infra/cache/replacement.cpp ^
+   infra/cache/stack_distance.cpp ^
+   infra/trace/mapped_file.cpp ^
+   infra/trace/address_trace.cpp ^
+   infra/trace/branch_trace.cpp ^
+   cache/cache_level.cpp ^
+   cache/prefetcher.cpp ^
+   cache/memory_backend.cpp ^
+   cache/cache_hierarchy.cpp ^
+   bpu/bpu.cpp ^
+   bpu/global_history.cpp ^
+   bpu/tage.cpp ^
+   bpu/perceptron.cpp ^
+   bpu/hybrid.cpp ^
+   bpu/ittage.cpp ^
+   bpu/loop.cpp ^
    mips/mips_instr.cpp ^
    func_sim/func_sim.cpp ^
-   core/perf_sim.cpp || exit /b
+   core/front_end_predictor.cpp ^
+   core/fetch_unit.cpp ^
+   core/perf_sim.cpp ^
+   core/ooo_sim.cpp
+
+rem Build object files
+cl %FLAGS% %SOURCES% || exit /b
 
 rem Build GoogleTest
 cl /EHsc /c /nologo /MD ^
@@ -30,7 +55,7 @@ set TRUNK=%cd%
 set TRUNKX=%TRUNK:\=\\%
 
 rem Build and run all the tests
-for %%G in (infra\elf_parser infra\memory mips func_sim bpu core) do (
+for %%G in (infra infra\elf_parser infra\memory infra\trace mips func_sim bpu cache core) do (
     echo Testing %%G
     cd %%G\t
     cl /nologo unit_test.cpp %TRUNK%\*.obj %TRUNK%\..\libelf\lib\libelf.lib ^
@@ -43,12 +68,18 @@ for %%G in (infra\elf_parser infra\memory mips func_sim bpu core) do (
 )
 
 rem Build main.cpp
-cl /I. /EHsc /c /nologo /MD ^
-   /D__LIBELF_INTERNAL__=1 ^
-   /D_HAS_AUTO_PTR_ETC=1 ^
-   /W4 /WX /wd4505 /wd4244 /wd4996 /wd4267 ^
-   /std:c++17 ^
-   main.cpp || exit /b
+cl %FLAGS% main.cpp || exit /b
 
 rem Build MIPT-MIPS
 cl ..\libelf\lib\libelf.lib *.obj /Femipt-mips /nologo /MD || exit /b
+
+rem Build branch predictor simulator
+del main.obj
+cl %FLAGS% bp_sim.cpp || exit /b
+cl ..\libelf\lib\libelf.lib *.obj /Febp-sim /nologo /MD || exit /b
+
+rem Build MIPT-MIPS with detailed output (-d option), its objects are kept apart
+if not exist trace mkdir trace
+del trace\*.obj
+cl %FLAGS% /DENABLE_TRACE /Fotrace\ %SOURCES% main.cpp || exit /b
+cl ..\libelf\lib\libelf.lib trace\*.obj /Femipt-mips-trace /nologo /MD || exit /b
@@ -0,0 +1,128 @@
+/*
+ * cache_hierarchy.cpp - composable hierarchy of caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <string>
+
+#include <infra/config/config.h>
+
+#include "cache_hierarchy.h"
+
+namespace config {
+    static Value<uint32> icache_size = { "icache-size", 32768, "L1 instruction cache size in bytes"};
+    static Value<uint32> icache_ways = { "icache-ways", 8, "number of ways in L1 instruction cache"};
+    static Value<uint32> icache_line_size = { "icache-line-size", 64, "L1 instruction cache line size in bytes"};
+    static Value<uint32> icache_mshrs = { "icache-mshrs", 2, "number of MSHRs in L1 instruction cache"};
+    static Value<std::string> icache_prefetcher = { "icache-prefetcher", "none", "L1 instruction cache prefetcher: next_line, stride, stream, or none"};
+
+    static Value<uint32> dcache_size = { "dcache-size", 32768, "L1 data cache size in bytes"};
+    static Value<uint32> dcache_ways = { "dcache-ways", 8, "number of ways in L1 data cache"};
+    static Value<uint32> dcache_line_size = { "dcache-line-size", 64, "L1 data cache line size in bytes"};
+    static Value<uint32> dcache_hit_latency = { "dcache-hit-latency", 1, "L1 data cache hit latency in cycles"};
+    static Value<uint32> dcache_mshrs = { "dcache-mshrs", 8, "number of MSHRs in L1 data cache"};
+    static Value<std::string> dcache_prefetcher = { "dcache-prefetcher", "none", "L1 data cache prefetcher: next_line, stride, stream, or none"};
+
+    static Value<uint32> prefetch_degree = { "prefetch-degree", 2, "number of lines prefetched ahead"};
+
+    static Value<std::string> replacement = { "cache-replacement", "lru", "replacement policy of caches: lru, plru, nru, srrip, brrip, or random"};
+
+    static Value<uint32> l2_size = { "l2-size", 262144, "L2 cache size in bytes"};
+    static Value<uint32> l2_ways = { "l2-ways", 8, "number of ways in L2 cache"};
+    static Value<uint32> l2_line_size = { "l2-line-size", 64, "L2 cache line size in bytes"};
+    static Value<uint32> l2_latency = { "l2-latency", 10, "L2 cache hit latency in cycles"};
+    static Value<uint32> l2_mshrs = { "l2-mshrs", 16, "number of MSHRs in L2 cache"};
+
+    static Value<uint32> l3_size = { "l3-size", 0, "L3 cache size in bytes, 0 means no L3 cache"};
+    static Value<uint32> l3_ways = { "l3-ways", 16, "number of ways in L3 cache"};
+    static Value<uint32> l3_line_size = { "l3-line-size", 64, "L3 cache line size in bytes"};
+    static Value<uint32> l3_latency = { "l3-latency", 30, "L3 cache hit latency in cycles"};
+    static Value<uint32> l3_mshrs = { "l3-mshrs", 32, "number of MSHRs in L3 cache"};
+
+    static Value<uint32> mem_latency = { "mem-latency", 100, "memory latency in cycles"};
+    static Value<uint32> mem_bandwidth = { "mem-bandwidth", 0, "memory bandwidth in bytes per cycle, 0 means unlimited"};
+} // namespace config
+
+CacheHierarchy::CacheHierarchy()
+{
+    /* instruction cache is pipelined, so its hit latency does not stall fetch */
+    l1i = std::make_unique<L1Cache>( "L1I", config::icache_size, config::icache_ways,
+                                     config::icache_line_size, 1, config::icache_mshrs, config::replacement);
+    l1d = std::make_unique<L1Cache>( "L1D", config::dcache_size, config::dcache_ways,
+                                     config::dcache_line_size, config::dcache_hit_latency, config::dcache_mshrs,
+                                     config::replacement);
+
+    PrefetcherFactory prefetcher_factory;
+    const std::string& icache_prefetcher = config::icache_prefetcher;
+    if ( icache_prefetcher != "none")
+        l1i->set_prefetcher( prefetcher_factory.create( icache_prefetcher,
+                                                        config::icache_line_size, config::prefetch_degree));
+
+    const std::string& dcache_prefetcher = config::dcache_prefetcher;
+    if ( dcache_prefetcher != "none")
+        l1d->set_prefetcher( prefetcher_factory.create( dcache_prefetcher,
+                                                        config::dcache_line_size, config::prefetch_degree));
+
+    shared.push_back( std::make_unique<SharedCache>( "L2", config::l2_size, config::l2_ways,
+                                                     config::l2_line_size, config::l2_latency, config::l2_mshrs,
+                                                     config::replacement));
+    if ( config::l3_size != 0)
+        shared.push_back( std::make_unique<SharedCache>( "L3", config::l3_size, config::l3_ways,
+                                                         config::l3_line_size, config::l3_latency, config::l3_mshrs,
+                                                         config::replacement));
+
+    const auto& last = shared.back();
+    memory = std::make_unique<MemoryBackend>( config::mem_latency, config::mem_bandwidth, last->get_line_size());
+
+    /* connecting levels from top to bottom */
+    const auto& l2 = shared.front();
+    for ( auto* l1 : { l1i.get(), l1d.get()})
+    {
+        l1->connect( l2->get_name(), l2->get_latency());
+        l2->add_client( l1->get_name());
+    }
+
+    for ( size_t i = 1; i < shared.size(); ++i)
+    {
+        shared[ i - 1]->connect( shared[ i]->get_name(), shared[ i]->get_latency());
+        shared[ i]->add_client( shared[ i - 1]->get_name());
+    }
+
+    last->connect( memory->get_name(), memory->get_latency());
+    memory->add_client( last->get_name());
+}
+
+Cycles CacheHierarchy::get_miss_latency() const
+{
+    Cycles latency = memory->get_latency();
+    for ( const auto& level : shared)
+        latency += level->get_latency();
+
+    return latency;
+}
+
+Cycles CacheHierarchy::get_max_miss_latency() const
+{
+    /* the line may wait for transfer of the lines missed by all the MSHRs of the last level */
+    return get_miss_latency() + memory->get_transfer_cycles() * shared.back()->get_num_mshrs();
+}
+
+void CacheHierarchy::clock( Cycles cycle)
+{
+    memory->clock( cycle);
+    for ( auto& level : shared)
+        level->clock( cycle);
+
+    l1i->clock( cycle);
+    l1d->clock( cycle);
+}
+
+void CacheHierarchy::dump_statistics( std::ostream& out) const
+{
+    l1i->dump_statistics( out);
+    l1d->dump_statistics( out);
+    for ( const auto& level : shared)
+        level->dump_statistics( out);
+
+    memory->dump_statistics( out);
+}
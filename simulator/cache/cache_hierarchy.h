@@ -0,0 +1,48 @@
+/*
+ * cache_hierarchy.h - composable hierarchy of caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef CACHE_HIERARCHY_H
+#define CACHE_HIERARCHY_H
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include <infra/types.h>
+
+#include "cache_level.h"
+#include "memory_backend.h"
+
+/*
+ * L1 instruction and data caches are in front of unified L2,
+ * optional L3 and memory backend. Levels are configured by options
+ * and connected through ports, so the hierarchy should be constructed
+ * before ports initialization and clocked every cycle.
+ */
+class CacheHierarchy
+{
+    std::unique_ptr<L1Cache> l1i = nullptr;
+    std::unique_ptr<L1Cache> l1d = nullptr;
+    std::vector<std::unique_ptr<SharedCache>> shared = {};
+    std::unique_ptr<MemoryBackend> memory = nullptr;
+
+public:
+    CacheHierarchy();
+
+    L1Cache& get_l1i() { return *l1i; }
+    L1Cache& get_l1d() { return *l1d; }
+
+    /* latency of L1 miss which hits nowhere, without queueing */
+    Cycles get_miss_latency() const;
+
+    /* upper bound of L1 miss latency, used to detect deadlocks */
+    Cycles get_max_miss_latency() const;
+
+    void clock( Cycles cycle);
+
+    void dump_statistics( std::ostream& out) const;
+};
+
+#endif // CACHE_HIERARCHY_H
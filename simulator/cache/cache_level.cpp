@@ -0,0 +1,299 @@
+/*
+ * cache_level.cpp - levels of cache hierarchy
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <iomanip>
+
+#include "cache_level.h"
+
+static const uint32 PORT_LATENCY = 1;
+static const uint32 PORT_FANOUT = 1;
+static const uint32 PORT_BW = 1;
+static const size_t PREFETCH_QUEUE_SIZE = 8;
+
+CacheLevel::CacheLevel( const std::string& name,
+                        uint32 size_in_bytes,
+                        uint32 ways,
+                        uint32 line_size,
+                        uint32 hit_latency,
+                        uint32 num_mshrs,
+                        const std::string& replacement)
+    : Log( false)
+    , name( name)
+    , hit_latency( hit_latency)
+    , num_mshrs( num_mshrs)
+    , tags( size_in_bytes, ways, line_size, 32, replacement)
+{
+    if ( hit_latency == 0)
+        serr << "ERROR: Wrong arguments! Hit latency of " << name
+             << " should be greater than zero" << std::endl << critical;
+
+    if ( num_mshrs == 0)
+        serr << "ERROR: Wrong arguments! Number of MSHRs of " << name
+             << " should be greater than zero" << std::endl << critical;
+}
+
+void CacheLevel::connect( const std::string& lower_name, uint32 lower_latency)
+{
+    wp_lower_request = make_write_port<Addr>( name + "_2_" + lower_name, PORT_BW, PORT_FANOUT);
+    rp_lower_response = make_read_port<Addr>( lower_name + "_2_" + name, lower_latency);
+}
+
+void CacheLevel::fill( Addr addr)
+{
+    /* the line may be allocated by store while it was requested */
+    if ( !tags.read_no_touch( addr).first)
+        tags.write( addr);
+}
+
+void CacheLevel::dump_statistics( std::ostream& out) const
+{
+    out << std::left << std::setw( 10) << name + ":" << std::right
+        << hits << " hits, " << misses << " misses, "
+        << merged << " merged, " << blocked_cycles << " blocked cycles" << std::endl;
+}
+
+L1Cache::MSHR* L1Cache::find_mshr( Addr line)
+{
+    auto it = std::find_if( mshrs.begin(), mshrs.end(),
+                            [line]( const MSHR& mshr) { return mshr.line == line; });
+
+    return it == mshrs.end() ? nullptr : &*it;
+}
+
+void L1Cache::train_prefetcher( const PrefetchAccess& access)
+{
+    if ( prefetcher == nullptr)
+        return;
+
+    for ( const auto addr : prefetcher->observe( access))
+    {
+        const auto line = get_line( addr);
+        if ( std::find( prefetches.begin(), prefetches.end(), line) != prefetches.end())
+            continue;
+
+        /* the oldest prefetches are dropped as they are likely to be late */
+        if ( prefetches.size() == PREFETCH_QUEUE_SIZE)
+            prefetches.pop_front();
+
+        prefetches.push_back( line);
+    }
+}
+
+L1Cache::Access L1Cache::read( Addr addr, Addr PC)
+{
+    PrefetchAccess access;
+    access.PC = PC;
+    access.addr = addr;
+
+    const auto line = get_line( addr);
+    if ( tags.read( addr).first)
+    {
+        ++hits;
+        access.is_first_use = prefetched_lines.erase( line) != 0;
+        if ( access.is_first_use)
+            prefetcher->count_useful();
+
+        train_prefetcher( access);
+        return Access::HIT;
+    }
+
+    auto* mshr = find_mshr( line);
+    if ( mshr == nullptr && mshrs.size() == num_mshrs)
+    {
+        ++blocked_cycles;
+        return Access::BLOCKED;
+    }
+
+    ++misses;
+    access.is_miss = true;
+    prefetched_lines.erase( line); // prefetched line was evicted before use
+
+    if ( mshr != nullptr)
+    {
+        ++merged;
+        if ( mshr->is_prefetch)
+            prefetcher->count_late();
+
+        mshr->is_prefetch = false;
+    }
+    else
+    {
+        if ( prefetcher != nullptr)
+            prefetcher->count_miss();
+
+        MSHR new_mshr;
+        new_mshr.line = line;
+        mshrs.push_back( new_mshr);
+        requests.push_back( line);
+    }
+
+    train_prefetcher( access);
+    return Access::MISS;
+}
+
+void L1Cache::write( Addr addr)
+{
+    if ( tags.read( addr).first)
+    {
+        ++hits;
+        return;
+    }
+
+    ++misses;
+    tags.write( addr);
+}
+
+void L1Cache::send_prefetch( Cycles cycle)
+{
+    while ( !prefetches.empty() && mshrs.size() < num_mshrs)
+    {
+        const auto line = prefetches.front();
+        prefetches.pop_front();
+
+        const auto addr = line * tags.line_size;
+        if ( tags.read_no_touch( addr).first || find_mshr( line) != nullptr)
+            continue;
+
+        MSHR mshr;
+        mshr.line = line;
+        mshr.is_prefetch = true;
+        mshrs.push_back( mshr);
+
+        prefetcher->count_issued();
+        wp_lower_request->write( addr, cycle);
+        return;
+    }
+}
+
+void L1Cache::clock( Cycles cycle)
+{
+    Addr addr = NO_VAL32;
+    while ( rp_lower_response->read( &addr, cycle))
+    {
+        fill( addr);
+
+        auto* mshr = find_mshr( get_line( addr));
+        assert( mshr != nullptr);
+        if ( mshr->is_prefetch)
+            prefetched_lines.insert( mshr->line);
+
+        mshrs.erase( mshrs.begin() + ( mshr - mshrs.data()));
+    }
+
+    /* demand misses have priority over prefetches */
+    if ( !requests.empty())
+    {
+        wp_lower_request->write( requests.front() * tags.line_size, cycle);
+        requests.pop_front();
+    }
+    else
+    {
+        send_prefetch( cycle);
+    }
+}
+
+void L1Cache::dump_statistics( std::ostream& out) const
+{
+    CacheLevel::dump_statistics( out);
+    if ( prefetcher != nullptr)
+        prefetcher->dump_statistics( out);
+}
+
+void SharedCache::add_client( const std::string& client_name)
+{
+    Client client;
+    client.rp_request = make_read_port<Addr>( client_name + "_2_" + name, PORT_LATENCY);
+    client.wp_response = make_write_port<Addr>( name + "_2_" + client_name, PORT_BW, PORT_FANOUT);
+    clients.push_back( std::move( client));
+}
+
+SharedCache::MSHR* SharedCache::find_mshr( Addr line)
+{
+    auto it = std::find_if( mshrs.begin(), mshrs.end(),
+                            [line]( const MSHR& mshr) { return mshr.line == line; });
+
+    return it == mshrs.end() ? nullptr : &*it;
+}
+
+void SharedCache::clock( Cycles cycle)
+{
+    for ( size_t i = 0; i < clients.size(); ++i)
+    {
+        Request request;
+        request.client = i;
+        while ( clients[ i].rp_request->read( &request.addr, cycle))
+            queue.push_back( request);
+    }
+
+    /* filling occupies the array for a cycle */
+    Addr addr = NO_VAL32;
+    if ( rp_lower_response->read( &addr, cycle))
+    {
+        fill( addr);
+
+        auto* mshr = find_mshr( get_line( addr));
+        assert( mshr != nullptr);
+
+        /*
+         * Client gets one response per cycle. If it has several merged requests
+         * (its lines are smaller), the rest are served as hits later.
+         */
+        std::vector<bool> is_responded( clients.size(), false);
+        std::vector<Request> replays;
+        for ( const auto& request : mshr->requests)
+        {
+            if ( is_responded[ request.client])
+            {
+                replays.push_back( request);
+                continue;
+            }
+
+            clients[ request.client].wp_response->write( request.addr, cycle);
+            is_responded[ request.client] = true;
+        }
+
+        queue.insert( queue.begin(), replays.begin(), replays.end());
+        mshrs.erase( mshrs.begin() + ( mshr - mshrs.data()));
+        return;
+    }
+
+    if ( queue.empty())
+        return;
+
+    const auto request = queue.front();
+    const auto line = get_line( request.addr);
+
+    auto* mshr = find_mshr( line);
+    if ( mshr != nullptr)
+    {
+        ++misses;
+        ++merged;
+        mshr->requests.push_back( request);
+    }
+    else if ( tags.read( request.addr).first)
+    {
+        ++hits;
+        clients[ request.client].wp_response->write( request.addr, cycle);
+    }
+    else if ( mshrs.size() < num_mshrs)
+    {
+        ++misses;
+        MSHR new_mshr;
+        new_mshr.line = line;
+        new_mshr.requests.push_back( request);
+        mshrs.push_back( new_mshr);
+        wp_lower_request->write( request.addr, cycle);
+    }
+    else
+    {
+        /* the request waits for a free MSHR */
+        ++blocked_cycles;
+        return;
+    }
+
+    queue.pop_front();
+}
@@ -0,0 +1,185 @@
+/*
+ * cache_level.h - levels of cache hierarchy
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef CACHE_LEVEL_H
+#define CACHE_LEVEL_H
+
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include <infra/cache/cache_tag_array.h>
+#include <infra/log.h>
+#include <infra/ports/ports.h>
+#include <infra/types.h>
+
+#include "prefetcher.h"
+
+/*
+ * Levels exchange addresses of lines through ports:
+ * request goes from upper level to the lower one, and the same address
+ * comes back as response when the line is filled.
+ * Response port latency is the hit latency of the responding level.
+ * Misses are tracked by miss status holding registers (MSHRs):
+ * a miss to the line which is already requested is merged with it,
+ * and hits are served while misses are outstanding.
+ * Write-back traffic is not modeled.
+ */
+class CacheLevel : protected Log
+{
+protected:
+    const std::string name;
+    const uint32 hit_latency;
+    const uint32 num_mshrs;
+    CacheTagArray tags;
+
+    uint64 hits = 0;
+    uint64 misses = 0;
+    uint64 merged = 0;  // secondary misses
+    uint64 blocked_cycles = 0; // cycles of misses waiting for a free MSHR
+
+    /* connection to the lower level */
+    std::unique_ptr<WritePort<Addr>> wp_lower_request = nullptr;
+    std::unique_ptr<ReadPort<Addr>> rp_lower_response = nullptr;
+
+    /* writes the line coming from the lower level */
+    void fill( Addr addr);
+
+public:
+    CacheLevel( const std::string& name,
+                uint32 size_in_bytes,
+                uint32 ways,
+                uint32 line_size,
+                uint32 hit_latency,
+                uint32 num_mshrs,
+                const std::string& replacement);
+
+    const std::string& get_name() const { return name; }
+    uint32 get_line_size() const { return tags.line_size; }
+    uint32 get_latency() const { return hit_latency; }
+    uint32 get_num_mshrs() const { return num_mshrs; }
+
+    /* number of the line containing the address */
+    Addr get_line( Addr addr) const { return tags.tag( addr); }
+
+    /* creates ports to the lower level */
+    void connect( const std::string& lower_name, uint32 lower_latency);
+
+    virtual void clock( Cycles cycle) = 0;
+
+    virtual void dump_statistics( std::ostream& out) const;
+
+    virtual ~CacheLevel() = default;
+};
+
+/*
+ * First level cache is looked up by pipeline stage directly,
+ * only the misses are sent to the lower level, one per cycle.
+ * Prefetches are sent when there are no demand misses to send
+ * and an MSHR is free.
+ */
+class L1Cache : public CacheLevel
+{
+    struct MSHR
+    {
+        Addr line = NO_VAL32;
+        bool is_prefetch = false; // no demand access to the line yet
+    };
+
+    std::vector<MSHR> mshrs = {};     // lines requested from the lower level
+    std::deque<Addr> requests = {};   // lines waiting to be sent
+    std::deque<Addr> prefetches = {}; // lines to be prefetched
+
+    std::unique_ptr<BasePrefetcher> prefetcher = nullptr;
+    std::unordered_set<Addr> prefetched_lines = {}; // filled by prefetch and not used yet
+
+    MSHR* find_mshr( Addr line);
+    void train_prefetcher( const PrefetchAccess& access);
+    void send_prefetch( Cycles cycle);
+
+public:
+    enum class Access { HIT, MISS, BLOCKED };
+
+    L1Cache( const std::string& name,
+             uint32 size_in_bytes,
+             uint32 ways,
+             uint32 line_size,
+             uint32 hit_latency,
+             uint32 num_mshrs,
+             const std::string& replacement)
+        : CacheLevel( name, size_in_bytes, ways, line_size, hit_latency, num_mshrs, replacement)
+    { }
+
+    void set_prefetcher( std::unique_ptr<BasePrefetcher> value) { prefetcher = std::move( value); }
+
+    /*
+     * Looks up the line and requests it on miss, PC of the instruction trains prefetcher.
+     * If there is no free MSHR, the access should be repeated later.
+     */
+    Access read( Addr addr, Addr PC);
+
+    /* looks up the line and allocates it on miss without fetching, used by stores */
+    void write( Addr addr);
+
+    /* checks if the line is in the cache now */
+    bool is_ready( Addr addr) const { return tags.read_no_touch( addr).first; }
+
+    void clock( Cycles cycle) final;
+
+    void dump_statistics( std::ostream& out) const final;
+};
+
+/*
+ * Cache shared by several upper levels.
+ * One request is looked up per cycle. The requests are served in order,
+ * so the queue waits if the front one misses and all MSHRs are busy.
+ */
+class SharedCache : public CacheLevel
+{
+    struct Client
+    {
+        std::unique_ptr<ReadPort<Addr>> rp_request = nullptr;
+        std::unique_ptr<WritePort<Addr>> wp_response = nullptr;
+    };
+
+    struct Request
+    {
+        size_t client = 0;
+        Addr addr = NO_VAL32;
+    };
+
+    struct MSHR
+    {
+        Addr line = NO_VAL32;
+        std::vector<Request> requests = {}; // the first one is primary miss
+    };
+
+    std::vector<Client> clients = {};
+    std::deque<Request> queue = {};
+    std::vector<MSHR> mshrs = {};
+
+    MSHR* find_mshr( Addr line);
+
+public:
+    SharedCache( const std::string& name,
+                 uint32 size_in_bytes,
+                 uint32 ways,
+                 uint32 line_size,
+                 uint32 hit_latency,
+                 uint32 num_mshrs,
+                 const std::string& replacement)
+        : CacheLevel( name, size_in_bytes, ways, line_size, hit_latency, num_mshrs, replacement)
+    { }
+
+    /* creates ports to the upper level */
+    void add_client( const std::string& client_name);
+
+    void clock( Cycles cycle) final;
+};
+
+#endif // CACHE_LEVEL_H
@@ -0,0 +1,52 @@
+/*
+ * memory_backend.cpp - DRAM latency model
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <iomanip>
+
+#include "memory_backend.h"
+
+static const uint32 PORT_LATENCY = 1;
+static const uint32 PORT_FANOUT = 1;
+static const uint32 PORT_BW = 1;
+
+MemoryBackend::MemoryBackend( uint32 latency, uint32 bandwidth, uint32 line_size)
+    : Log( false)
+    , latency( latency)
+    , transfer_cycles( bandwidth == 0 ? 1 : ( line_size + bandwidth - 1) / bandwidth)
+{
+    if ( latency == 0)
+        serr << "ERROR: Wrong arguments! Memory latency should be greater than zero"
+             << std::endl << critical;
+}
+
+void MemoryBackend::add_client( const std::string& client_name)
+{
+    rp_request = make_read_port<Addr>( client_name + "_2_" + name, PORT_LATENCY);
+    wp_response = make_write_port<Addr>( name + "_2_" + client_name, PORT_BW, PORT_FANOUT);
+}
+
+void MemoryBackend::clock( Cycles cycle)
+{
+    Addr addr = NO_VAL32;
+    while ( rp_request->read( &addr, cycle))
+    {
+        queue.push_back( addr);
+        ++requests;
+    }
+
+    /* the channel is busy with transfer of the previous line */
+    if ( queue.empty() || cycle < next_free_cycle)
+        return;
+
+    wp_response->write( queue.front(), cycle);
+    queue.pop_front();
+    next_free_cycle = cycle + transfer_cycles;
+}
+
+void MemoryBackend::dump_statistics( std::ostream& out) const
+{
+    out << std::left << std::setw( 10) << name + ":" << std::right
+        << requests << " requests" << std::endl;
+}
@@ -0,0 +1,52 @@
+/*
+ * memory_backend.h - DRAM latency model
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef MEMORY_BACKEND_H
+#define MEMORY_BACKEND_H
+
+#include <deque>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include <infra/log.h>
+#include <infra/ports/ports.h>
+#include <infra/types.h>
+
+/*
+ * Each line is delivered with a fixed latency. If bandwidth is limited,
+ * transfer of a line occupies the channel for line_size / bandwidth cycles,
+ * and other requests wait for it.
+ */
+class MemoryBackend : protected Log
+{
+    const std::string name = "MEMORY";
+    const uint32 latency;
+    const uint32 transfer_cycles;
+
+    std::unique_ptr<ReadPort<Addr>> rp_request = nullptr;
+    std::unique_ptr<WritePort<Addr>> wp_response = nullptr;
+
+    std::deque<Addr> queue = {};
+    Cycles next_free_cycle = 0;
+    uint64 requests = 0;
+
+public:
+    /* zero bandwidth means it is not limited */
+    MemoryBackend( uint32 latency, uint32 bandwidth, uint32 line_size);
+
+    const std::string& get_name() const { return name; }
+    uint32 get_latency() const { return latency; }
+    uint32 get_transfer_cycles() const { return transfer_cycles; }
+
+    /* creates ports to the upper level */
+    void add_client( const std::string& client_name);
+
+    void clock( Cycles cycle);
+
+    void dump_statistics( std::ostream& out) const;
+};
+
+#endif // MEMORY_BACKEND_H
@@ -0,0 +1,179 @@
+/*
+ * prefetcher.cpp - hardware prefetchers of caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <algorithm>
+#include <iomanip>
+
+#include "prefetcher.h"
+
+static const uint32 STRIDE_TABLE_SIZE = 64;
+static const uint32 STRIDE_CONFIDENCE_MAX = 3;
+static const uint32 STRIDE_CONFIDENCE_THRESHOLD = 2;
+static const uint32 STREAMS_NUM = 4;
+
+BasePrefetcher::BasePrefetcher( const std::string& name, uint32 line_size, uint32 degree)
+    : Log( false)
+    , name( name)
+    , line_size( line_size)
+    , degree( degree)
+{
+    if ( degree == 0)
+        serr << "ERROR: Wrong arguments! Prefetch degree should be greater than zero"
+             << std::endl << critical;
+}
+
+void BasePrefetcher::dump_statistics( std::ostream& out) const
+{
+    const auto used = useful + late;
+    const auto accuracy = issued == 0 ? 0. : 1.0 * used / issued;
+    const auto coverage = used + misses == 0 ? 0. : 1.0 * used / ( used + misses);
+    const auto timeliness = used == 0 ? 0. : 1.0 * useful / used;
+
+    out << std::setw( 10) << "" << name << " prefetcher: "
+        << issued << " issued, " << accuracy << " accuracy, "
+        << coverage << " coverage, " << timeliness << " timeliness" << std::endl;
+}
+
+std::vector<Addr> NextLinePrefetcher::observe( const PrefetchAccess& access)
+{
+    std::vector<Addr> result;
+    if ( !access.is_miss && !access.is_first_use)
+        return result;
+
+    const auto line = get_line( access.addr);
+    for ( uint32 i = 1; i <= degree; ++i)
+        result.push_back( ( line + i) * line_size);
+
+    return result;
+}
+
+StridePrefetcher::StridePrefetcher( uint32 line_size, uint32 degree)
+    : BasePrefetcher( "stride", line_size, degree)
+    , table( STRIDE_TABLE_SIZE)
+{ }
+
+std::vector<Addr> StridePrefetcher::observe( const PrefetchAccess& access)
+{
+    std::vector<Addr> result;
+
+    auto& entry = table[ ( access.PC / 4) % table.size()];
+    if ( entry.PC != access.PC)
+    {
+        entry = Entry();
+        entry.PC = access.PC;
+        entry.last_addr = access.addr;
+        return result;
+    }
+
+    const auto stride = static_cast<int64>( access.addr) - static_cast<int64>( entry.last_addr);
+    entry.last_addr = access.addr;
+
+    if ( stride == entry.stride)
+    {
+        entry.confidence = std::min( entry.confidence + 1, STRIDE_CONFIDENCE_MAX);
+    }
+    else if ( entry.confidence > 0)
+    {
+        --entry.confidence;
+    }
+    else
+    {
+        entry.stride = stride;
+    }
+
+    if ( entry.confidence < STRIDE_CONFIDENCE_THRESHOLD || entry.stride == 0)
+        return result;
+
+    /* small strides hit the same line several times, it is prefetched once */
+    auto last_line = get_line( access.addr);
+    for ( uint32 i = 1; i <= degree; ++i)
+    {
+        const auto addr = static_cast<Addr>( access.addr + i * entry.stride);
+        if ( get_line( addr) != last_line)
+            result.push_back( addr);
+
+        last_line = get_line( addr);
+    }
+
+    return result;
+}
+
+StreamPrefetcher::StreamPrefetcher( uint32 line_size, uint32 degree)
+    : BasePrefetcher( "stream", line_size, degree)
+    , streams( STREAMS_NUM)
+{ }
+
+std::vector<Addr> StreamPrefetcher::observe( const PrefetchAccess& access)
+{
+    std::vector<Addr> result;
+    if ( !access.is_miss && !access.is_first_use)
+        return result;
+
+    ++access_count;
+    const auto line = get_line( access.addr);
+
+    /* the line is one of prefetched by stream */
+    auto it = std::find_if( streams.begin(), streams.end(), [this, line]( const Stream& stream) {
+        return stream.is_confirmed && line <= stream.head && line + degree > stream.head;
+    });
+
+    if ( it == streams.end())
+    {
+        /* the line next to candidate confirms it */
+        it = std::find_if( streams.begin(), streams.end(), [line]( const Stream& stream) {
+            return !stream.is_confirmed && stream.head != NO_VAL32 && stream.head + 1 == line;
+        });
+
+        if ( it == streams.end())
+        {
+            it = std::min_element( streams.begin(), streams.end(), []( const Stream& a, const Stream& b) {
+                return a.last_use < b.last_use;
+            });
+            it->head = line;
+            it->is_confirmed = false;
+            it->last_use = access_count;
+            return result;
+        }
+
+        it->head = line;
+        it->is_confirmed = true;
+    }
+
+    it->last_use = access_count;
+    for ( ; it->head < line + degree; ++it->head)
+        result.push_back( ( it->head + 1) * line_size);
+
+    return result;
+}
+
+PrefetcherFactory::PrefetcherFactory()
+    : Log( false)
+    , map({ { "next_line", new PrefetcherCreator<NextLinePrefetcher>},
+            { "stride",    new PrefetcherCreator<StridePrefetcher>},
+            { "stream",    new PrefetcherCreator<StreamPrefetcher>}})
+{ }
+
+PrefetcherFactory::~PrefetcherFactory()
+{
+    for ( auto& elem : map)
+        delete elem.second;
+}
+
+std::unique_ptr<BasePrefetcher> PrefetcherFactory::create( const std::string& name,
+                                                           uint32 line_size,
+                                                           uint32 degree) const
+{
+    if ( map.find( name) == map.end())
+    {
+        serr << "ERROR: Invalid prefetcher " << name << std::endl
+             << "Supported prefetchers:" << std::endl;
+        for ( const auto& map_name : map)
+            serr << "\t" << map_name.first << std::endl;
+
+        serr << critical;
+    }
+
+    return map.at( name)->create( line_size, degree);
+}
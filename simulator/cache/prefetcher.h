@@ -0,0 +1,159 @@
+/*
+ * prefetcher.h - hardware prefetchers of caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef PREFETCHER_H
+#define PREFETCHER_H
+
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <infra/log.h>
+#include <infra/types.h>
+
+/* demand access observed by prefetcher */
+struct PrefetchAccess
+{
+    Addr PC = NO_VAL32;
+    Addr addr = NO_VAL32;
+    bool is_miss = false;      // line was not in the cache
+    bool is_first_use = false; // first hit to the prefetched line
+};
+
+/*
+ * Prefetcher observes demand accesses and returns addresses of lines
+ * to be prefetched. The cache issues them when it has free MSHRs
+ * and counts how they were used:
+ *     accuracy   -- part of issued prefetches used by demand accesses,
+ *     coverage   -- part of demand misses eliminated or shortened by prefetches,
+ *     timeliness -- part of used prefetches which came before demand access.
+ */
+class BasePrefetcher : private Log
+{
+    const std::string name;
+
+    uint64 issued = 0;
+    uint64 useful = 0; // prefetched lines hit by demand accesses
+    uint64 late = 0;   // demand misses to the lines being prefetched
+    uint64 misses = 0; // demand misses not covered by prefetches
+
+protected:
+    const uint32 line_size;
+    const uint32 degree; // number of lines prefetched ahead
+
+    Addr get_line( Addr addr) const { return addr / line_size; }
+
+public:
+    BasePrefetcher( const std::string& name, uint32 line_size, uint32 degree);
+    virtual ~BasePrefetcher() = default;
+
+    virtual std::vector<Addr> observe( const PrefetchAccess& access) = 0;
+
+    void count_issued() { ++issued; }
+    void count_useful() { ++useful; }
+    void count_late() { ++late; }
+    void count_miss() { ++misses; }
+
+    void dump_statistics( std::ostream& out) const;
+};
+
+/* prefetches lines following the missed one */
+class NextLinePrefetcher : public BasePrefetcher
+{
+public:
+    NextLinePrefetcher( uint32 line_size, uint32 degree)
+        : BasePrefetcher( "next_line", line_size, degree)
+    { }
+
+    std::vector<Addr> observe( const PrefetchAccess& access) final;
+};
+
+/*
+ * Reference prediction table indexed by PC: instruction accessing memory
+ * with the same stride twice in a row gets next addresses prefetched.
+ */
+class StridePrefetcher : public BasePrefetcher
+{
+    struct Entry
+    {
+        Addr PC = NO_VAL32;
+        Addr last_addr = NO_VAL32;
+        int64 stride = 0;
+        uint32 confidence = 0;
+    };
+
+    std::vector<Entry> table;
+
+public:
+    StridePrefetcher( uint32 line_size, uint32 degree);
+
+    std::vector<Addr> observe( const PrefetchAccess& access) final;
+};
+
+/*
+ * Stream buffers follow ascending sequences of misses. A miss to the line
+ * prefetched by the stream advances it. Other misses are kept as candidates
+ * in place of the least recently used streams, a miss to the line next to
+ * a candidate confirms it, so isolated misses do not start streams.
+ */
+class StreamPrefetcher : public BasePrefetcher
+{
+    struct Stream
+    {
+        Addr head = NO_VAL32; // the last prefetched line, or the missed one of candidate
+        bool is_confirmed = false;
+        uint64 last_use = 0;
+    };
+
+    std::vector<Stream> streams;
+    uint64 access_count = 0;
+
+public:
+    StreamPrefetcher( uint32 line_size, uint32 degree);
+
+    std::vector<Addr> observe( const PrefetchAccess& access) final;
+};
+
+/*
+ *******************************************************************************
+ *                                FACTORY CLASS                                *
+ *******************************************************************************
+ */
+class PrefetcherFactory : private Log {
+    class BasePrefetcherCreator {
+    public:
+        virtual std::unique_ptr<BasePrefetcher> create( uint32 line_size,
+                                                        uint32 degree) const = 0;
+        virtual ~BasePrefetcherCreator() = default;
+    };
+
+    template<typename T>
+    class PrefetcherCreator : public BasePrefetcherCreator {
+    public:
+        std::unique_ptr<BasePrefetcher> create( uint32 line_size,
+                                                uint32 degree) const final
+        {
+            return std::make_unique<T>( line_size, degree);
+        }
+    };
+
+    const std::map<std::string, BasePrefetcherCreator*> map;
+
+public:
+    PrefetcherFactory();
+    ~PrefetcherFactory();
+
+    /* forbid copies */
+    PrefetcherFactory& operator=( const PrefetcherFactory&) = delete;
+    PrefetcherFactory( const PrefetcherFactory&) = delete;
+
+    std::unique_ptr<BasePrefetcher> create( const std::string& name,
+                                            uint32 line_size,
+                                            uint32 degree) const;
+};
+
+#endif // PREFETCHER_H
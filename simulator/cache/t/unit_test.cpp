@@ -0,0 +1,445 @@
+// generic C
+#include <cassert>
+#include <cstdlib>
+
+// generic C++
+#include <sstream>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Module
+#include <infra/cache/cache_tag_array.h>
+#include <infra/cache/replacement.h>
+#include <infra/cache/stack_distance.h>
+#include <infra/config/config.h>
+#include <infra/ports/ports.h>
+
+#include "../cache_hierarchy.h"
+#include "../prefetcher.h"
+
+/* Sets options for the test, other options get their default values */
+static void handle_args( std::vector<const char*> args)
+{
+    args.insert( args.begin(), "mipt-mips");
+    config::handleArgs( args.size(), const_cast<char**>( args.data())); // NOLINT
+}
+
+/* Clocks the hierarchy till the line comes to L1, returns the cycle of arrival */
+static Cycles wait_for_line( CacheHierarchy* caches, L1Cache* l1, Addr addr, Cycles cycle)
+{
+    while ( !l1->is_ready( addr))
+        caches->clock( ++cycle);
+
+    return cycle;
+}
+
+TEST( CacheHierarchy, Miss_Goes_Down_To_Memory)
+{
+    CacheHierarchy caches;
+    init_ports();
+
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    caches.clock( 0);
+
+    // request to each level takes a cycle, and lines come back with the latencies of levels
+    ASSERT_EQ( wait_for_line( &caches, &l1d, 0x1000, 0), 2 + 10 + 100);
+    ASSERT_EQ( caches.get_miss_latency(), 10 + 100);
+
+    // the whole line is filled
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::HIT);
+    ASSERT_EQ( l1d.read( 0x103f, 0), L1Cache::Access::HIT);
+    ASSERT_FALSE( l1d.is_ready( 0x1040));
+
+    destroy_ports();
+}
+
+TEST( CacheHierarchy, Line_Is_Shared_By_L1_Caches)
+{
+    CacheHierarchy caches;
+    init_ports();
+
+    auto& l1d = caches.get_l1d();
+    auto& l1i = caches.get_l1i();
+
+    l1d.read( 0x2000, 0);
+    caches.clock( 0);
+    const Cycles cycle = wait_for_line( &caches, &l1d, 0x2000, 0);
+
+    // the line hits in L2, so memory is not accessed
+    ASSERT_EQ( l1i.read( 0x2000, 0), L1Cache::Access::MISS);
+    caches.clock( cycle + 1);
+    ASSERT_EQ( wait_for_line( &caches, &l1i, 0x2000, cycle + 1), cycle + 1 + 1 + 10);
+
+    destroy_ports();
+}
+
+TEST( CacheHierarchy, Third_Level)
+{
+    handle_args( { "--l3-size", "1048576", "--l3-latency", "20"});
+
+    CacheHierarchy caches;
+    init_ports();
+    ASSERT_EQ( caches.get_miss_latency(), 10 + 20 + 100);
+
+    auto& l1i = caches.get_l1i();
+    l1i.read( 0x3000, 0);
+    caches.clock( 0);
+    ASSERT_EQ( wait_for_line( &caches, &l1i, 0x3000, 0), 3 + 10 + 20 + 100);
+
+    destroy_ports();
+    handle_args( {});
+}
+
+TEST( CacheHierarchy, Limited_Memory_Bandwidth)
+{
+    handle_args( { "--mem-bandwidth", "16"});
+
+    CacheHierarchy caches;
+    init_ports();
+
+    // both misses reach memory in the same time, the second line waits for transfer of the first one
+    auto& l1i = caches.get_l1i();
+    auto& l1d = caches.get_l1d();
+    l1i.read( 0x4000, 0);
+    l1d.read( 0x8000, 0);
+    caches.clock( 0);
+
+    const Cycles first = wait_for_line( &caches, &l1i, 0x4000, 0);
+    const Cycles second = wait_for_line( &caches, &l1d, 0x8000, first);
+    ASSERT_EQ( first, 2 + 10 + 100);
+    ASSERT_GE( second, first + 64 / 16);
+
+    destroy_ports();
+    handle_args( {});
+}
+
+TEST( CacheHierarchy, Misses_Overlap)
+{
+    CacheHierarchy caches;
+    init_ports();
+
+    // both misses are sent before the first line comes
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    caches.clock( 0);
+    ASSERT_EQ( l1d.read( 0x2000, 0), L1Cache::Access::MISS);
+    caches.clock( 1);
+
+    const Cycles first = wait_for_line( &caches, &l1d, 0x1000, 1);
+    ASSERT_EQ( first, 2 + 10 + 100);
+    ASSERT_EQ( wait_for_line( &caches, &l1d, 0x2000, first), first + 1);
+
+    destroy_ports();
+}
+
+TEST( CacheHierarchy, Secondary_Miss_Is_Merged)
+{
+    CacheHierarchy caches;
+    init_ports();
+
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    caches.clock( 0);
+
+    // the first line is being filled, the rest of accesses are not blocked
+    ASSERT_EQ( wait_for_line( &caches, &l1d, 0x1000, 0), 2 + 10 + 100);
+    ASSERT_EQ( l1d.read( 0x2000, 0), L1Cache::Access::MISS);
+    ASSERT_EQ( l1d.read( 0x2008, 0), L1Cache::Access::MISS);
+    ASSERT_EQ( l1d.read( 0x1008, 0), L1Cache::Access::HIT);
+
+    std::ostringstream oss;
+    caches.dump_statistics( oss);
+    ASSERT_NE( oss.str().find( "L1D:      1 hits, 3 misses, 1 merged, 0 blocked cycles"), std::string::npos);
+
+    destroy_ports();
+}
+
+TEST( CacheHierarchy, No_Free_MSHR)
+{
+    handle_args( { "--dcache-mshrs", "1"});
+
+    CacheHierarchy caches;
+    init_ports();
+
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    ASSERT_EQ( l1d.read( 0x2000, 0), L1Cache::Access::BLOCKED);
+    caches.clock( 0);
+    ASSERT_EQ( l1d.read( 0x2000, 1), L1Cache::Access::BLOCKED);
+
+    // MSHR is free when the line comes
+    const Cycles cycle = wait_for_line( &caches, &l1d, 0x1000, 0);
+    ASSERT_EQ( l1d.read( 0x2000, 0), L1Cache::Access::MISS);
+    caches.clock( cycle + 1);
+    ASSERT_EQ( wait_for_line( &caches, &l1d, 0x2000, cycle + 1), cycle + 1 + 2 + 10 + 100);
+
+    // each retry of the blocked miss is counted
+    std::ostringstream oss;
+    caches.dump_statistics( oss);
+    ASSERT_NE( oss.str().find( "L1D:      0 hits, 2 misses, 0 merged, 2 blocked cycles"), std::string::npos);
+
+    destroy_ports();
+    handle_args( {});
+}
+
+TEST( CacheHierarchy, Next_Line_Prefetch)
+{
+    handle_args( { "--dcache-prefetcher", "next_line", "--prefetch-degree", "1"});
+
+    CacheHierarchy caches;
+    init_ports();
+
+    // the next line is requested after the missed one
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    caches.clock( 0);
+    caches.clock( 1);
+
+    const Cycles cycle = wait_for_line( &caches, &l1d, 0x1040, 1);
+    ASSERT_EQ( cycle, 3 + 10 + 100);
+    ASSERT_EQ( l1d.read( 0x1040, 0), L1Cache::Access::HIT);
+
+    std::ostringstream oss;
+    caches.dump_statistics( oss);
+    ASSERT_NE( oss.str().find( "next_line prefetcher: 1 issued, 1 accuracy, 0.5 coverage, 1 timeliness"), std::string::npos);
+
+    destroy_ports();
+    handle_args( {});
+}
+
+TEST( Prefetcher, Stride)
+{
+    PrefetcherFactory factory;
+    auto prefetcher = factory.create( "stride", 64, 2);
+
+    PrefetchAccess access;
+    access.PC = 0x400100;
+
+    // stride is confirmed twice before prefetching
+    for ( Addr addr : { 0x1000, 0x1100, 0x1200})
+    {
+        access.addr = addr;
+        ASSERT_TRUE( prefetcher->observe( access).empty());
+    }
+
+    access.addr = 0x1300;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x1400, 0x1500}));
+
+    // other instruction does not break the stride
+    PrefetchAccess other;
+    other.PC = 0x400104;
+    other.addr = 0x8000;
+    ASSERT_TRUE( prefetcher->observe( other).empty());
+
+    access.addr = 0x1400;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x1500, 0x1600}));
+}
+
+TEST( Prefetcher, Stream)
+{
+    PrefetcherFactory factory;
+    auto prefetcher = factory.create( "stream", 64, 2);
+
+    // stream is started by misses to two adjacent lines
+    PrefetchAccess access;
+    access.addr = 0x1000;
+    access.is_miss = true;
+    ASSERT_TRUE( prefetcher->observe( access).empty());
+
+    access.addr = 0x1040;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x1080, 0x10c0}));
+
+    // hits are not observed, unless it is the first use of prefetched line
+    access.addr = 0x1080;
+    access.is_miss = false;
+    ASSERT_TRUE( prefetcher->observe( access).empty());
+
+    access.is_first_use = true;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x1100}));
+
+    // isolated misses out of the stream do not start new ones
+    access.is_miss = true;
+    access.is_first_use = false;
+    for ( Addr addr : { 0x8000, 0x9000, 0x7fc0})
+    {
+        access.addr = addr;
+        ASSERT_TRUE( prefetcher->observe( access).empty());
+    }
+
+    access.addr = 0x8040;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x8080, 0x80c0}));
+
+    // the first stream is still followed
+    access.addr = 0x10c0;
+    ASSERT_EQ( prefetcher->observe( access), std::vector<Addr>( { 0x1140}));
+}
+
+TEST( Prefetcher, Wrong_Parameters)
+{
+    PrefetcherFactory factory;
+    ASSERT_EXIT( factory.create( "ideal", 64, 2), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( factory.create( "stride", 64, 0), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( CacheTagArray, Fully_Associative_Search)
+{
+    CacheTagArray tags( 1024, 256);
+
+    // number of lines is not a multiple of vector width
+    for ( Addr addr = 0; addr < 4 * 13; addr += 4)
+        ASSERT_EQ( tags.write( addr), addr / 4);
+
+    for ( Addr addr = 0; addr < 4 * 13; addr += 4)
+        ASSERT_EQ( tags.read( addr + 3), std::make_pair( true, addr / 4));
+
+    // tags of invalid ways are not matched
+    ASSERT_FALSE( tags.read( 4 * 13).first);
+    ASSERT_FALSE( tags.read_no_touch( 4 * 255).first);
+}
+
+/* Counts misses of LRU cache simulated access by access */
+static uint64 count_misses( const std::vector<Addr>& trace, uint32 size, uint32 ways)
+{
+    CacheTagArray tags( size, ways);
+    uint64 misses = 0;
+    for ( const auto addr : trace)
+        if ( !tags.read( addr).first)
+        {
+            ++misses;
+            tags.write( addr);
+        }
+
+    return misses;
+}
+
+TEST( StackDistance, Same_Misses_As_Tag_Array)
+{
+    std::vector<Addr> trace;
+    for ( Addr i = 0; i < 4000; ++i)
+        trace.push_back( ( i * 0x9e3779b1) % 0x1000 + ( i % 7) * 0x400);
+
+    StackDistanceProfiler set_associative( 4, 16, 8);
+    ReuseDistanceProfiler full_associative( 4);
+    for ( const auto addr : trace)
+    {
+        set_associative.access( addr);
+        full_associative.access( addr);
+    }
+
+    ASSERT_EQ( set_associative.get_accesses(), trace.size());
+    for ( uint32 ways : { 1, 2, 4, 8})
+        ASSERT_EQ( set_associative.get_misses( ways), count_misses( trace, 16 * 4 * ways, ways));
+
+    for ( uint32 ways : { 1, 16, 256, 1024})
+        ASSERT_EQ( full_associative.get_misses( ways), count_misses( trace, 4 * ways, ways));
+}
+
+/* Fills the set of policy in order of ways */
+static std::unique_ptr<ReplacementPolicy> create_filled_set( const std::string& name, uint32 ways)
+{
+    auto policy = ReplacementPolicyFactory().create( name, ways, 1);
+    for ( uint32 way = 0; way < ways; ++way)
+        policy->insert( 0, way);
+
+    return policy;
+}
+
+TEST( Replacement, LRU)
+{
+    auto policy = create_filled_set( "lru", 4);
+    ASSERT_EQ( policy->get_victim( 0), 0u);
+    policy->touch( 0, 0);
+    ASSERT_EQ( policy->get_victim( 0), 1u);
+}
+
+TEST( Replacement, Tree_PLRU)
+{
+    auto policy = create_filled_set( "plru", 4);
+    ASSERT_EQ( policy->get_victim( 0), 0u);
+
+    // use of the way 0 points the root to the other half
+    policy->touch( 0, 0);
+    ASSERT_EQ( policy->get_victim( 0), 2u);
+}
+
+TEST( Replacement, NRU)
+{
+    // bits are cleared when the last way is used
+    auto policy = create_filled_set( "nru", 4);
+    ASSERT_EQ( policy->get_victim( 0), 0u);
+    policy->touch( 0, 0);
+    ASSERT_EQ( policy->get_victim( 0), 1u);
+}
+
+TEST( Replacement, RRIP)
+{
+    auto srrip = create_filled_set( "srrip", 2);
+    srrip->touch( 0, 0);
+    ASSERT_EQ( srrip->get_victim( 0), 1u);
+
+    // bimodal policy predicts that new line is not re-referenced
+    auto brrip = ReplacementPolicyFactory().create( "brrip", 2, 1);
+    brrip->insert( 0, 1);
+    brrip->touch( 0, 0);
+    ASSERT_EQ( brrip->get_victim( 0), 1u);
+}
+
+TEST( Replacement, Random_Is_Reproducible)
+{
+    auto first = create_filled_set( "random", 8);
+    auto second = create_filled_set( "random", 8);
+    for ( int i = 0; i < 100; ++i)
+    {
+        const auto victim = first->get_victim( 0);
+        ASSERT_LT( victim, 8u);
+        ASSERT_EQ( victim, second->get_victim( 0));
+    }
+}
+
+TEST( Replacement, Wrong_Parameters)
+{
+    ASSERT_EXIT( ReplacementPolicyFactory().create( "mru", 4, 1), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( ReplacementPolicyFactory().create( "plru", 3, 1), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( CacheHierarchy, Replacement_Policy)
+{
+    handle_args( { "--cache-replacement", "srrip"});
+
+    CacheHierarchy caches;
+    init_ports();
+
+    auto& l1d = caches.get_l1d();
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::MISS);
+    caches.clock( 0);
+    ASSERT_EQ( wait_for_line( &caches, &l1d, 0x1000, 0), 2 + 10 + 100);
+    ASSERT_EQ( l1d.read( 0x1000, 0), L1Cache::Access::HIT);
+
+    destroy_ports();
+    handle_args( { "--cache-replacement", "belady"});
+    ASSERT_EXIT( CacheHierarchy caches, ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    handle_args( {});
+}
+
+TEST( CacheHierarchy, Wrong_Latency)
+{
+    handle_args( { "--l2-latency", "0"});
+    ASSERT_EXIT( CacheHierarchy caches, ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    handle_args( { "--mem-latency", "0"});
+    ASSERT_EXIT( CacheHierarchy caches, ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+
+    handle_args( { "--l2-mshrs", "0"});
+    ASSERT_EXIT( CacheHierarchy caches, ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    handle_args( {});
+}
+
+int main( int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, argv);
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    return RUN_ALL_TESTS();
+}
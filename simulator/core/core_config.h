@@ -0,0 +1,68 @@
+/*
+ * core_config.h - options shared by performance models
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef CORE_CONFIG_H
+#define CORE_CONFIG_H
+
+#include <string>
+
+#include <bpu/bpu.h>
+#include <infra/config/config.h>
+
+namespace config {
+    inline Value<std::string> bp_mode = { "bp-mode", "dynamic_two_bit", "branch prediction mode"};
+    inline Value<uint32> bp_size = { "bp-size", 128, "BTB size in entries"};
+    inline Value<uint32> bp_ways = { "bp-ways", 16, "number of ways in BTB"};
+    inline Value<std::string> bp_replacement = { "bp-replacement", "lru", "replacement policy of BTB"};
+    inline Value<uint32> bp_history_length = { "bp-history-length", 8, "length of global branch history"};
+    inline Value<uint32> bp_pht_size = { "bp-pht-size", 4096, "number of counters in pattern history table"};
+    inline Value<uint32> bp_tage_tables = { "bp-tage-tables", 4, "number of TAGE tagged tables"};
+    inline Value<uint32> bp_tage_table_size = { "bp-tage-table-size", 1024, "number of entries in each TAGE tagged table"};
+    inline Value<uint32> bp_tage_min_history = { "bp-tage-min-history", 5, "history length of the first TAGE tagged table"};
+    inline Value<uint32> bp_tage_max_history = { "bp-tage-max-history", 130, "history length of the last TAGE tagged table"};
+    inline Value<uint32> bp_tage_min_tag_bits = { "bp-tage-min-tag-bits", 8, "tag width of the first TAGE tagged table"};
+    inline Value<uint32> bp_tage_max_tag_bits = { "bp-tage-max-tag-bits", 12, "tag width of the last TAGE tagged table"};
+    inline Value<uint32> bp_perceptron_history = { "bp-perceptron-history", 32, "length of global history of perceptron predictor"};
+    inline Value<uint32> bp_perceptron_size = { "bp-perceptron-size", 256, "number of perceptrons"};
+    inline Value<uint32> bp_chooser_size = { "bp-chooser-size", 4096, "number of counters in chooser of hybrid predictor"};
+    inline Value<uint32> bp_loop_size = { "bp-loop-size", 64, "number of entries in loop predictor"};
+    inline Value<uint32> bp_indirect_tables = { "bp-indirect-tables", 4, "number of tagged tables of indirect jump target predictor"};
+    inline Value<uint32> bp_indirect_table_size = { "bp-indirect-table-size", 512, "number of entries in each table of indirect jump target predictor"};
+    inline Value<uint32> bp_indirect_min_history = { "bp-indirect-min-history", 4, "path history length of the first indirect predictor tagged table"};
+    inline Value<uint32> bp_indirect_max_history = { "bp-indirect-max-history", 64, "path history length of the last indirect predictor tagged table"};
+    inline Value<uint32> bp_indirect_tag_bits = { "bp-indirect-tag-bits", 10, "tag width of indirect predictor tagged tables"};
+    inline Value<uint32> ras_size = { "ras-size", 16, "depth of return address stack, zero disables it"};
+
+    inline Value<uint32> width = { "width", 1, "number of instructions processed by each pipeline stage per cycle"};
+
+    /* parameters of branch predictor set by options */
+    inline BPParameters bp_parameters()
+    {
+        BPParameters params;
+        params.size_in_entries = bp_size;
+        params.ways = bp_ways;
+        params.replacement = bp_replacement;
+        params.history_length = bp_history_length;
+        params.pht_size_in_entries = bp_pht_size;
+        params.tage_tables = bp_tage_tables;
+        params.tage_table_size = bp_tage_table_size;
+        params.tage_min_history = bp_tage_min_history;
+        params.tage_max_history = bp_tage_max_history;
+        params.tage_min_tag_bits = bp_tage_min_tag_bits;
+        params.tage_max_tag_bits = bp_tage_max_tag_bits;
+        params.perceptron_history_length = bp_perceptron_history;
+        params.perceptron_table_size = bp_perceptron_size;
+        params.chooser_size_in_entries = bp_chooser_size;
+        params.loop_size_in_entries = bp_loop_size;
+        params.ittage_tables = bp_indirect_tables;
+        params.ittage_table_size = bp_indirect_table_size;
+        params.ittage_min_history = bp_indirect_min_history;
+        params.ittage_max_history = bp_indirect_max_history;
+        params.ittage_tag_bits = bp_indirect_tag_bits;
+        return params;
+    }
+} // namespace config
+
+#endif // CORE_CONFIG_H
@@ -0,0 +1,67 @@
+/*
+ * data_cache_read.h - data cache access of loads shared by performance models
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef DATA_CACHE_READ_H
+#define DATA_CACHE_READ_H
+
+#include <infra/types.h>
+
+#include <cache/cache_hierarchy.h>
+#include <mips/mips_instr.h>
+
+/*
+ * Miss is not accepted by the cache till an MSHR is free,
+ * and the cache is accessed again when the missed line comes.
+ */
+class DataCacheRead
+{
+    enum class State { ACCESS, MISS, HIT };
+    State state = State::ACCESS;
+    Cycles ready_cycle = NO_VAL64;
+
+public:
+    /* returns true when data of the load is read */
+    bool clock( L1Cache* l1d, const FuncInstr& load, Cycles cycle)
+    {
+        const Addr addr = load.get_mem_addr();
+        if ( state == State::ACCESS)
+        {
+            const auto access = l1d->read( addr, load.get_PC());
+            if ( access == L1Cache::Access::HIT)
+            {
+                state = State::HIT;
+                ready_cycle = cycle + l1d->get_latency() - 1;
+            }
+            else if ( access == L1Cache::Access::MISS)
+            {
+                state = State::MISS;
+            }
+        }
+
+        if ( state == State::MISS && l1d->is_ready( addr))
+        {
+            state = State::HIT;
+            ready_cycle = cycle + l1d->get_latency() - 1;
+        }
+
+        return state == State::HIT && ready_cycle <= cycle;
+    }
+};
+
+/*
+ * Cycles without retired instructions which mean deadlock.
+ * The oldest instruction misses in the instruction cache and then in the data cache,
+ * and each of these two misses may wait for a free MSHR released by an earlier miss,
+ * so it waits for four misses at most. Besides, a flush drains the pipeline,
+ * and the instruction passes each stage after it is filled again.
+ */
+inline Cycles get_deadlock_cycles( CacheHierarchy& caches, uint32 pipeline_depth)
+{
+    const Cycles max_misses = 2 * 2;
+    const Cycles refill_cycles = 2 * pipeline_depth;
+    return refill_cycles + caches.get_l1d().get_latency() + max_misses * caches.get_max_miss_latency();
+}
+
+#endif // DATA_CACHE_READ_H
@@ -0,0 +1,105 @@
+/*
+ * fetch_unit.cpp - fetch stage with branch prediction shared by performance models
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <iostream>
+
+#include "core_config.h"
+#include "fetch_unit.h"
+
+FetchUnit::FetchUnit( bool log, uint32 width, L1Cache* l1i)
+    : Log( log)
+    , width( width)
+    , l1i( l1i)
+    , predictor( config::bp_mode, config::bp_parameters(), config::ras_size)
+{ }
+
+void FetchUnit::init( const MIPSMemory* program)
+{
+    memory = program;
+    new_PC = memory->startPC();
+    is_fetch_miss = false;
+    is_group_sent = false;
+}
+
+void FetchUnit::flush( Addr target)
+{
+    PC = target; // fixing PC
+    new_PC = target;
+    predictor.flush();
+    is_fetch_miss = false; // line of the wrong path is not waited
+    is_group_sent = false;
+}
+
+void FetchUnit::clock( bool is_stall, WritePort<IfIdData>* wp, Cycles cycle)
+{
+    /* updating PC, the group stalled by the next stage is fetched and predicted again */
+    if ( !is_stall)
+        PC = new_PC;
+    else if ( is_group_sent)
+        predictor.restore();
+
+    new_PC = PC;
+    is_group_sent = false;
+
+    /* instruction cache lookup, PC is fetched again when line comes */
+    if ( !is_fetch_miss)
+    {
+        const auto access = l1i->read( PC, PC);
+        if ( access == L1Cache::Access::BLOCKED)
+        {
+            if constexpr ( trace_enabled)
+                sout << "fetch   cycle " << std::dec << cycle << ": 0x"
+                     << std::hex << PC << ": no free MSHR" << std::endl;
+            return;
+        }
+
+        is_fetch_miss = access == L1Cache::Access::MISS;
+    }
+
+    if ( is_fetch_miss && !l1i->is_ready( PC))
+    {
+        if constexpr ( trace_enabled)
+            sout << "fetch   cycle " << std::dec << cycle << ": 0x"
+                 << std::hex << PC << ": instruction cache miss" << std::endl;
+        return;
+    }
+
+    is_fetch_miss = false;
+
+    /* fetching a group of sequential instructions from one cache line */
+    const Addr line = l1i->get_line( PC);
+    predictor.checkpoint();
+    is_group_sent = true;
+    for ( uint32 i = 0; i < width; ++i)
+    {
+        IfIdData data;
+        data.raw = memory->fetch( new_PC);
+        data.PC = new_PC;
+
+        const auto prediction = predictor.predict( data.PC, data.raw);
+        data.predicted_taken = prediction.is_taken;
+        data.predicted_target = prediction.target;
+
+        /* updating PC according to prediction */
+        new_PC = data.predicted_target;
+
+        wp->write( data, cycle);
+
+        if constexpr ( trace_enabled)
+            sout << "fetch   cycle " << std::dec << cycle << ": 0x"
+                 << std::hex << data.PC << ": 0x" << data.raw << std::endl;
+
+        /* fetch group ends at the first predicted jump or at the end of line */
+        if ( new_PC != data.PC + 4 || l1i->get_line( new_PC) != line)
+            break;
+    }
+}
+
+void FetchUnit::update( const FuncInstr& instr)
+{
+    /* predictors are trained by all the branches, global history has to see each outcome */
+    if ( instr.isJump() || instr.is_misprediction())
+        predictor.update( instr.get_PC(), instr.get_raw(), instr.is_jump_taken(), instr.get_new_PC());
+}
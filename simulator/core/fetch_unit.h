@@ -0,0 +1,64 @@
+/*
+ * fetch_unit.h - fetch stage with branch prediction shared by performance models
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef FETCH_UNIT_H
+#define FETCH_UNIT_H
+
+#include <infra/log.h>
+#include <infra/ports/ports.h>
+#include <infra/types.h>
+
+#include <cache/cache_level.h>
+#include <mips/mips_instr.h>
+#include <mips/mips_memory.h>
+
+#include "front_end_predictor.h"
+
+/* the struture of data sent from fetch to the next stage */
+struct IfIdData {
+    bool predicted_taken = false;     // Predicted direction
+    Addr predicted_target = NO_VAL32; // PC, predicted by BPU
+    Addr PC = NO_VAL32;               // current PC
+    uint32 raw = NO_VAL32;            // fetched instruction code
+};
+
+/*
+ * Each cycle a group of sequential instructions is fetched from one line
+ * of the instruction cache, the group ends at the first predicted jump.
+ */
+class FetchUnit : protected Log
+{
+    const uint32 width;
+    L1Cache* const l1i;
+    const MIPSMemory* memory = nullptr;
+
+    Addr PC = NO_VAL32;
+    Addr new_PC = NO_VAL32;
+    bool is_fetch_miss = false; // waiting for instruction cache line
+    bool is_group_sent = false; // the last cycle has sent a group, stall makes it fetched again
+
+    FrontEndPredictor predictor;
+
+public:
+    FetchUnit( bool log, uint32 width, L1Cache* l1i);
+
+    /* forbid copies */
+    FetchUnit& operator=( const FetchUnit&) = delete;
+    FetchUnit( const FetchUnit&) = delete;
+
+    /* starts fetch from the entry point of the program */
+    void init( const MIPSMemory* program);
+
+    /* continues fetch from the target of mispredicted instruction */
+    void flush( Addr target);
+
+    /* sends the fetch group, the same PC is fetched again after stall */
+    void clock( bool is_stall, WritePort<IfIdData>* wp, Cycles cycle);
+
+    /* trains predictors by the resolved instruction */
+    void update( const FuncInstr& instr);
+};
+
+#endif // FETCH_UNIT_H
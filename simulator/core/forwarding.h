@@ -0,0 +1,178 @@
+/*
+ * forwarding.h - forwarding (bypass) unit of MIPS pipeline
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef FORWARDING_H
+#define FORWARDING_H
+
+#include <array>
+#include <sstream>
+#include <string>
+
+#include <infra/log.h>
+#include <infra/types.h>
+
+#include <mips/mips_instr.h>
+#include <mips/mips_rf.h>
+
+/*
+ * Instead of waiting for writeback, decode stage may send an instruction
+ * to execute if each its source will be bypassed to execute stage in time.
+ * Enabled paths are:
+ *   "execute" -- results of arithmetic instructions from EX/MEM latch,
+ *                so dependent instruction may be decoded right after producer;
+ *   "memory"  -- all the results from MEM/WB latch, so dependent instruction
+ *                may be decoded when producer has passed execute stage,
+ *                or when load has completed its memory access.
+ * Execute stage reads the youngest published value of each source,
+ * which is the value of the latest producer that is older than the reader.
+ * Memory and execute stages are clocked before decode stage.
+ */
+class Forwarding : private Log
+{
+    struct Entry
+    {
+        /* the youngest instruction in pipeline writing the register */
+        uint64 producer = NO_VAL64;
+        Cycles issue_cycle = 0;
+        bool is_load = false;
+        bool is_executed = false; // result is computed, or loaded for loads
+        Cycles execute_cycle = 0;
+
+        /* the youngest result available for bypassing */
+        bool has_result = false;
+        uint64 result_producer = NO_VAL64;
+        uint32 result = NO_VAL32;
+    };
+
+    std::array<Entry, REG_NUM_MAX> table = {};
+    const RF& rf;
+
+    bool from_execute = false;
+    bool from_memory = false;
+
+    Entry& get_entry( RegNum num) { return table.at( static_cast<size_t>( num)); }
+    const Entry& get_entry( RegNum num) const { return table.at( static_cast<size_t>( num)); }
+
+    bool is_available( RegNum num, Cycles cycle) const
+    {
+        if ( rf.check( num))
+            return true;
+
+        const auto& entry = get_entry( num);
+        if ( entry.producer == NO_VAL64) // producer is unknown, wait for writeback
+            return false;
+
+        if ( entry.is_load)
+            return from_memory && entry.is_executed;
+
+        if ( from_execute && entry.issue_cycle < cycle)
+            return true;
+
+        return from_memory && entry.is_executed && entry.execute_cycle < cycle;
+    }
+
+    uint32 read( RegNum num) const
+    {
+        const auto& entry = get_entry( num);
+        return entry.has_result ? entry.result : rf.read( num);
+    }
+
+    void publish( const FuncInstr& instr, Cycles cycle)
+    {
+        const auto num = instr.get_dst_num();
+        if ( num == REG_NUM_ZERO)
+            return;
+
+        auto& entry = get_entry( num);
+        if ( entry.producer == instr.get_sequence_id())
+        {
+            entry.is_executed = true;
+            entry.execute_cycle = cycle;
+        }
+
+        /* older load may come from memory later than younger result */
+        if ( entry.has_result && entry.result_producer > instr.get_sequence_id())
+            return;
+
+        entry.has_result = true;
+        entry.result_producer = instr.get_sequence_id();
+        entry.result = instr.get_v_dst();
+    }
+
+public:
+    Forwarding( const RF& rf, const std::string& paths) : Log( false), rf( rf)
+    {
+        std::istringstream iss( paths);
+        std::string path;
+        while ( std::getline( iss, path, ','))
+        {
+            if ( path == "execute")
+                from_execute = true;
+            else if ( path == "memory")
+                from_memory = true;
+            else if ( path != "none")
+                serr << "ERROR: Wrong arguments! Unknown forwarding path " << path
+                     << ", supported paths are: execute, memory, none" << std::endl << critical;
+        }
+    }
+
+    /* decode stage */
+    bool check_sources( const FuncInstr& instr, Cycles cycle) const
+    {
+        return rf.check_sources( instr)
+            || ( is_available( instr.get_src1_num(), cycle)
+              && is_available( instr.get_src2_num(), cycle));
+    }
+
+    void issue( const FuncInstr& instr, Cycles cycle)
+    {
+        const auto num = instr.get_dst_num();
+        if ( num == REG_NUM_ZERO)
+            return;
+
+        auto& entry = get_entry( num);
+        entry.producer = instr.get_sequence_id();
+        entry.issue_cycle = cycle;
+        entry.is_load = instr.is_load();
+        entry.is_executed = false;
+    }
+
+    /* execute stage */
+    void read_sources( FuncInstr* instr) const
+    {
+        instr->set_v_src1( read( instr->get_src1_num()));
+        instr->set_v_src2( read( instr->get_src2_num()));
+    }
+
+    void execute( const FuncInstr& instr, Cycles cycle)
+    {
+        if ( !instr.is_load())
+            publish( instr, cycle);
+    }
+
+    /* memory stage, called when access is completed */
+    void complete( const FuncInstr& instr, Cycles cycle)
+    {
+        if ( instr.is_load())
+            publish( instr, cycle);
+    }
+
+    /* flush */
+    void cancel( const FuncInstr& instr)
+    {
+        const auto num = instr.get_dst_num();
+        if ( num == REG_NUM_ZERO)
+            return;
+
+        auto& entry = get_entry( num);
+        if ( entry.producer == instr.get_sequence_id())
+            entry.producer = NO_VAL64;
+
+        if ( entry.has_result && entry.result_producer == instr.get_sequence_id())
+            entry.has_result = false;
+    }
+};
+
+#endif // FORWARDING_H
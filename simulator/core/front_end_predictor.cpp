@@ -0,0 +1,83 @@
+/*
+ * front_end_predictor.cpp - predictors of fetch stage
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <mips/mips_instr.h>
+
+#include "front_end_predictor.h"
+
+FrontEndPredictor::FrontEndPredictor( const std::string& mode, const BPParameters& params, uint32 ras_size)
+    : ras( ras_size)
+    , committed_ras( ras_size)
+    , group_ras( ras_size)
+    , indirect_bp( params)
+{
+    BPFactory bp_factory;
+    bp = bp_factory.create( mode, params);
+}
+
+BPPrediction FrontEndPredictor::predict( Addr PC, uint32 raw)
+{
+    BPPrediction prediction = bp->predict( PC);
+
+    /* returns are predicted by the stack, other indirect jumps by the target predictor */
+    if ( FuncInstr::is_return( raw) && !ras.empty())
+    {
+        prediction.is_taken = true;
+        prediction.target = ras.pop();
+    }
+    else if ( FuncInstr::is_indirect_jump( raw) && indirect_bp.get_target( PC) != NO_VAL32)
+    {
+        prediction.is_taken = true;
+        prediction.target = indirect_bp.get_target( PC);
+    }
+
+    /* calls push their return addresses */
+    if ( FuncInstr::is_call( raw))
+        ras.push( PC + 4);
+
+    /* the same instructions as the ones updating predictors when resolved, mispredictions are flushed */
+    if ( FuncInstr::is_jump( raw) || prediction.is_taken)
+        bp->speculative_update( prediction.is_taken, PC);
+    if ( prediction.is_taken)
+        indirect_bp.speculative_update_path( prediction.target);
+
+    return prediction;
+}
+
+void FrontEndPredictor::update( Addr PC, uint32 raw, bool is_taken, Addr target)
+{
+    bp->update( is_taken, PC, target);
+
+    if ( FuncInstr::is_return( raw))
+        committed_ras.pop();
+    else if ( FuncInstr::is_call( raw))
+        committed_ras.push( PC + 4);
+
+    if ( FuncInstr::is_indirect_jump( raw))
+        indirect_bp.update( PC, target);
+    if ( is_taken)
+        indirect_bp.update_path( target);
+}
+
+void FrontEndPredictor::flush()
+{
+    ras = committed_ras;
+    bp->flush();
+    indirect_bp.flush();
+}
+
+void FrontEndPredictor::checkpoint()
+{
+    group_ras = ras;
+    bp->checkpoint();
+    indirect_bp.checkpoint();
+}
+
+void FrontEndPredictor::restore()
+{
+    ras = group_ras;
+    bp->restore();
+    indirect_bp.restore();
+}
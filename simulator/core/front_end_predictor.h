@@ -0,0 +1,56 @@
+/*
+ * front_end_predictor.h - predictors of fetch stage
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef FRONT_END_PREDICTOR_H
+#define FRONT_END_PREDICTOR_H
+
+#include <memory>
+#include <string>
+
+#include <infra/types.h>
+
+#include <bpu/bpu.h>
+#include <bpu/ittage.h>
+#include <bpu/ras.h>
+
+/*
+ * Directions and targets are predicted by BPU, returns by the return address stack,
+ * other indirect jumps by the target predictor. Instructions are pre-decoded,
+ * so the predictions are made before decode.
+ * Predictors are trained by resolved branches. Fetched branches change
+ * the stack and histories speculatively, they are repaired on flush
+ * from the ones changed by resolved branches.
+ */
+class FrontEndPredictor
+{
+    std::unique_ptr<BaseBP> bp = nullptr;
+
+    /* speculative stack of fetch and the one updated by resolved instructions */
+    ReturnAddressStack ras;
+    ReturnAddressStack committed_ras;
+    ReturnAddressStack group_ras; // speculative stack before the last fetch group
+    ITTAGE indirect_bp;
+
+public:
+    FrontEndPredictor( const std::string& mode, const BPParameters& params, uint32 ras_size);
+
+    /* prediction of the fetched instruction, branches change the stack and histories */
+    BPPrediction predict( Addr PC, uint32 raw);
+
+    /* trains predictors by the resolved branch */
+    void update( Addr PC, uint32 raw, bool is_taken, Addr target);
+
+    /* branches of the wrong path are undone */
+    void flush();
+
+    /*
+     * Fetch group thrown away by the next stage is fetched again,
+     * so its branches are undone before it is predicted again.
+     */
+    void checkpoint();
+    void restore();
+};
+
+#endif // FRONT_END_PREDICTOR_H
@@ -0,0 +1,82 @@
+/*
+ * issue_queue.h - issue queue (reservation station) of out-of-order MIPS core
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef ISSUE_QUEUE_H
+#define ISSUE_QUEUE_H
+
+#include <array>
+#include <utility>
+#include <vector>
+
+#include <infra/types.h>
+
+#include <mips/mips_instr.h>
+
+/*
+ * Renamed instructions wait here for their sources,
+ * and the oldest ready ones are sent to execution.
+ */
+class IssueQueue
+{
+public:
+    struct Source
+    {
+        RegNum num = REG_NUM_ZERO;
+        uint64 producer = NO_VAL64; // NO_VAL64 if value is captured
+        uint32 value = NO_VAL32;
+    };
+
+    struct Entry
+    {
+        FuncInstr instr = {};
+        std::array<Source, 2> sources = {};
+        Cycles dispatch_cycle = 0;
+    };
+
+private:
+    /* in program order, the storage is allocated once for all the entries */
+    std::vector<Entry> entries = {};
+    const size_t size;
+
+public:
+    explicit IssueQueue( size_t size) : size( size) { entries.reserve( size); }
+
+    bool is_full() const { return entries.size() == size; }
+
+    void push( const Entry& entry) { entries.push_back( entry); }
+
+    /*
+     * Takes at most 'max' oldest entries satisfying the predicate.
+     * Predicate may capture values of sources, so it receives a pointer.
+     */
+    template<typename Predicate>
+    std::vector<FuncInstr> select( size_t max, Predicate is_ready)
+    {
+        std::vector<FuncInstr> result;
+
+        /* the rest of entries are moved to the front in one pass */
+        auto last = entries.begin();
+        for ( auto it = entries.begin(); it != entries.end(); ++it)
+        {
+            if ( result.size() < max && is_ready( &*it))
+            {
+                it->instr.set_v_src1( it->sources[0].value);
+                it->instr.set_v_src2( it->sources[1].value);
+                result.push_back( it->instr);
+                continue;
+            }
+
+            if ( last != it)
+                *last = std::move( *it);
+            ++last;
+        }
+        entries.erase( last, entries.end());
+        return result;
+    }
+
+    void clear() { entries.clear(); }
+};
+
+#endif // ISSUE_QUEUE_H
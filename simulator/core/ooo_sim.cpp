@@ -0,0 +1,509 @@
+/*
+ * ooo_sim.cpp - out-of-order mips performance simulator
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#include <algorithm>
+#include <iostream>
+
+#include <boost/chrono.hpp>
+#include <boost/timer/timer.hpp>
+
+#include <infra/config/config.h>
+
+#include "core_config.h"
+#include "ooo_sim.h"
+
+static const uint32 PORT_LATENCY = 1;
+static const uint32 PORT_FANOUT = 1;
+static const uint32 PORT_BW = 1;
+static const uint32 FLUSHED_STAGES_NUM = 4;
+
+namespace config {
+    static Value<uint32> rob_size = { "rob-size", 32, "number of entries in reorder buffer"};
+    static Value<uint32> iq_size = { "iq-size", 16, "number of entries in each issue queue"};
+} // namespace config
+
+OoOMIPS::OoOMIPS( bool log)
+    : Log( log)
+    , width( config::width)
+    , rob( config::rob_size)
+    , alu_queue( config::iq_size)
+    , mem_queue( config::iq_size)
+    , checker( false)
+{
+    if ( width == 0)
+        serr << "ERROR: Wrong arguments! Pipeline width should be greater than zero"
+             << std::endl << critical;
+
+    if ( config::rob_size == 0 || config::iq_size == 0)
+        serr << "ERROR: Wrong arguments! Sizes of reorder buffer and issue queues should be greater than zero"
+             << std::endl << critical;
+
+    wp_fetch_2_rename = make_write_port<IfIdData>("FETCH_2_RENAME", width, PORT_FANOUT);
+    rp_fetch_2_rename = make_read_port<IfIdData>("FETCH_2_RENAME", PORT_LATENCY);
+    wp_rename_2_fetch_stall = make_write_port<bool>("RENAME_2_FETCH_STALL", PORT_BW, PORT_FANOUT);
+    rp_rename_2_fetch_stall = make_read_port<bool>("RENAME_2_FETCH_STALL", PORT_LATENCY);
+
+    wp_issue_2_execute = make_write_port<FuncInstr>("ISSUE_2_EXECUTE", width, PORT_FANOUT);
+    rp_issue_2_execute = make_read_port<FuncInstr>("ISSUE_2_EXECUTE", PORT_LATENCY);
+    wp_issue_2_memory = make_write_port<FuncInstr>("ISSUE_2_MEMORY", width, PORT_FANOUT);
+    rp_issue_2_memory = make_read_port<FuncInstr>("ISSUE_2_MEMORY", PORT_LATENCY);
+
+    /* branch misprediction unit ports */
+    wp_commit_2_all_flush = make_write_port<bool>("COMMIT_2_ALL_FLUSH", PORT_BW, FLUSHED_STAGES_NUM);
+    rp_fetch_flush = make_read_port<bool>("COMMIT_2_ALL_FLUSH", PORT_LATENCY);
+    rp_rename_flush = make_read_port<bool>("COMMIT_2_ALL_FLUSH", PORT_LATENCY);
+    rp_execute_flush = make_read_port<bool>("COMMIT_2_ALL_FLUSH", PORT_LATENCY);
+    rp_memory_flush = make_read_port<bool>("COMMIT_2_ALL_FLUSH", PORT_LATENCY);
+
+    wp_commit_2_fetch_target = make_write_port<Addr>("COMMIT_2_FETCH_TARGET", PORT_BW, PORT_FANOUT);
+    rp_commit_2_fetch_target = make_read_port<Addr>("COMMIT_2_FETCH_TARGET", PORT_LATENCY);
+
+    caches = std::make_unique<CacheHierarchy>();
+    fetch_unit = std::make_unique<FetchUnit>( log, width, &caches->get_l1i());
+
+    deadlock_cycles = get_deadlock_cycles( *caches, PIPELINE_DEPTH);
+
+    init_ports();
+}
+
+OoOMIPS::~OoOMIPS()
+{
+    destroy_ports();
+}
+
+void OoOMIPS::run( const std::string& tr,
+                   uint64 instrs_to_run)
+{
+    assert( instrs_to_run < MAX_VAL32);
+    Cycles cycle = 0;
+
+    memory = std::make_unique<MIPSMemory>( tr);
+
+    checker.init( tr);
+
+    fetch_unit->init( memory.get());
+
+    boost::timer::cpu_timer timer;
+
+    /*
+     * Execution units write results to the reorder buffer before issue stage,
+     * so dependent instruction may be issued in the next cycle after producer.
+     * Commit is the last, so flush cleans the structures when all the stages
+     * are done with them.
+     */
+    while (executed_instrs < instrs_to_run)
+    {
+        caches->clock( cycle);
+        clock_fetch( cycle);
+        clock_rename( cycle);
+        clock_execute( cycle);
+        clock_memory( cycle);
+        clock_issue( cycle);
+        clock_commit( cycle);
+        ++cycle;
+
+        if constexpr ( trace_enabled)
+            sout << "Executed instructions: " << std::dec << executed_instrs
+                 << std::endl << std::endl;
+
+        check_ports( cycle);
+    }
+
+    cycles = cycle;
+    auto time = timer.elapsed().wall;
+
+    /* buffered log should be printed before the statistics */
+    LogSink::drain();
+
+    auto frequency = 1e6 * cycle / time;
+    auto ipc = 1.0 * executed_instrs / cycle;
+    auto simips = 1e6 * executed_instrs / time;
+
+    std::cout << std::endl << "****************************"
+              << std::endl << "cycles:   " << cycle
+              << std::endl << "IPC:      " << ipc
+              << std::endl << "sim freq: " << frequency << " kHz"
+              << std::endl << "sim IPS:  " << simips    << " kips"
+              << std::endl;
+
+    caches->dump_statistics( std::cout);
+
+    std::cout << "****************************" << std::endl;
+}
+
+void OoOMIPS::clock_fetch( Cycles cycle)
+{
+    /* receive flush and stall signals */
+    bool is_flush = false;
+    rp_fetch_flush->read( &is_flush, cycle);
+
+    bool is_stall = false;
+    rp_rename_2_fetch_stall->read( &is_stall, cycle);
+
+    if ( is_flush)
+    {
+        Addr target = NO_VAL32;
+        rp_commit_2_fetch_target->read( &target, cycle);
+        fetch_unit->flush( target);
+    }
+
+    fetch_unit->clock( is_stall, wp_fetch_2_rename.get(), cycle);
+}
+
+IssueQueue::Source OoOMIPS::rename_source( RegNum num)
+{
+    IssueQueue::Source source;
+    source.num = num;
+    source.producer = rename_table.get_producer( num);
+    if ( source.producer == NO_VAL64)
+        source.value = arch_regs.at( static_cast<size_t>( num));
+    else
+        wakeup( &source);
+
+    return source;
+}
+
+void OoOMIPS::clock_rename( Cycles cycle)
+{
+    /* receive flush signal */
+    bool is_flush = false;
+    rp_rename_flush->read( &is_flush, cycle);
+
+    IfIdData data;
+    if ( is_flush)
+    {
+        /* ignoring the upcoming instructions as they are invalid */
+        while ( rp_fetch_2_rename->read( &data, cycle))
+            ;
+
+        rename_data.clear();
+        if constexpr ( trace_enabled)
+            sout << "rename  cycle " << std::dec << cycle << ": flush\n";
+        return;
+    }
+
+    if ( rename_data.empty())
+    {
+        while ( rp_fetch_2_rename->read( &data, cycle))
+            rename_data.push_back( data);
+    }
+    else
+    {
+        /* ignore data from port -- to suppress loss messages */
+        while ( rp_fetch_2_rename->read( &data, cycle))
+            ;
+    }
+
+    if ( rename_data.empty())
+    {
+        if constexpr ( trace_enabled)
+            sout << "rename  cycle " << std::dec << cycle << ": bubble\n";
+        return;
+    }
+
+    while ( !rename_data.empty())
+    {
+        const auto& front = rename_data.front();
+        IssueQueue::Entry entry;
+        entry.instr = FuncInstr( front.raw,
+                                 front.PC,
+                                 front.predicted_taken,
+                                 front.predicted_target);
+
+        if constexpr ( trace_enabled)
+            sout << "rename  cycle " << std::dec << cycle << ": ";
+
+        const bool is_memory = entry.instr.is_load() || entry.instr.is_store();
+        auto& queue = is_memory ? mem_queue : alu_queue;
+        if ( rob.is_full() || queue.is_full()) // structural hazard, stalling pipeline
+        {
+            wp_rename_2_fetch_stall->write( true, cycle);
+            if constexpr ( trace_enabled)
+                sout << entry.instr << " (no free entries)\n";
+            return;
+        }
+
+        entry.instr.set_sequence_id( sequence_id++);
+        entry.sources[0] = rename_source( entry.instr.get_src1_num());
+        entry.sources[1] = rename_source( entry.instr.get_src2_num());
+        entry.dispatch_cycle = cycle;
+        rename_table.rename( entry.instr);
+
+        rob.allocate( entry.instr);
+        queue.push( entry);
+        if ( entry.instr.is_store())
+            stores.push_back( entry.instr.get_sequence_id());
+
+        rename_data.pop_front();
+
+        if constexpr ( trace_enabled)
+            sout << entry.instr << std::endl;
+    }
+}
+
+bool OoOMIPS::wakeup( IssueQueue::Source* source)
+{
+    if ( source->producer == NO_VAL64)
+        return true;
+
+    const auto* entry = rob.find( source->producer);
+    if ( entry != nullptr && !entry->is_complete)
+        return false;
+
+    /* producer is committed, so its value is in the register file */
+    source->value = entry != nullptr
+                    ? entry->instr.get_v_dst()
+                    : arch_regs.at( static_cast<size_t>( source->num));
+    source->producer = NO_VAL64;
+    return true;
+}
+
+bool OoOMIPS::is_ready( IssueQueue::Entry* entry)
+{
+    /* memory is not disambiguated, so loads wait for all the older stores */
+    if ( entry->instr.is_load() && !stores.empty() && stores.front() < entry->instr.get_sequence_id())
+        return false;
+
+    /* both sources are checked to capture values as soon as possible */
+    const bool src1_ready = wakeup( &entry->sources[0]);
+    const bool src2_ready = wakeup( &entry->sources[1]);
+    return src1_ready && src2_ready;
+}
+
+void OoOMIPS::clock_issue( Cycles cycle)
+{
+    const auto is_issuable = [this, cycle]( IssueQueue::Entry* entry) {
+        return entry->dispatch_cycle < cycle && is_ready( entry);
+    };
+
+    bool is_bubble = true;
+    for ( const auto& instr : alu_queue.select( width, is_issuable))
+    {
+        is_bubble = false;
+        wp_issue_2_execute->write( instr, cycle);
+        if constexpr ( trace_enabled)
+            sout << "issue   cycle " << std::dec << cycle << ": " << instr << std::endl;
+    }
+
+    for ( const auto& instr : mem_queue.select( width, is_issuable))
+    {
+        is_bubble = false;
+        wp_issue_2_memory->write( instr, cycle);
+        if constexpr ( trace_enabled)
+            sout << "issue   cycle " << std::dec << cycle << ": " << instr << std::endl;
+    }
+
+    if constexpr ( trace_enabled)
+        if ( is_bubble)
+            sout << "issue   cycle " << std::dec << cycle << ": bubble\n";
+}
+
+void OoOMIPS::complete( const FuncInstr& instr, Cycles cycle)
+{
+    auto* entry = rob.find( instr.get_sequence_id());
+    assert( entry != nullptr);
+    entry->instr = instr;
+    entry->is_complete = true;
+    entry->complete_cycle = cycle;
+}
+
+void OoOMIPS::clock_execute( Cycles cycle)
+{
+    FuncInstr instr;
+
+    /* receive flush signal */
+    bool is_flush = false;
+    rp_execute_flush->read( &is_flush, cycle);
+
+    if ( is_flush)
+    {
+        /* ignoring the upcoming instructions as they are invalid */
+        while ( rp_issue_2_execute->read( &instr, cycle))
+            ;
+
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": flush\n";
+        return;
+    }
+
+    bool is_bubble = true;
+    while ( rp_issue_2_execute->read( &instr, cycle))
+    {
+        is_bubble = false;
+
+        /* instruction may be on the wrong path, so unknown ones are reported at commit */
+        if ( !instr.is_unknown())
+            instr.execute();
+
+        complete( instr, cycle);
+
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": " << instr << std::endl;
+    }
+
+    if constexpr ( trace_enabled)
+        if ( is_bubble)
+            sout << "execute cycle " << std::dec << cycle << ": bubble\n";
+}
+
+void OoOMIPS::clock_memory( Cycles cycle)
+{
+    FuncInstr instr;
+
+    /* receive flush signal */
+    bool is_flush = false;
+    rp_memory_flush->read( &is_flush, cycle);
+
+    if ( is_flush)
+    {
+        /* ignoring the upcoming instructions as they are invalid */
+        while ( rp_issue_2_memory->read( &instr, cycle))
+            ;
+
+        /* requested lines are filled anyway, but nobody waits for them */
+        loads.clear();
+
+        if constexpr ( trace_enabled)
+            sout << "memory  cycle " << std::dec << cycle << ": flush\n";
+        return;
+    }
+
+    bool is_bubble = true;
+    while ( rp_issue_2_memory->read( &instr, cycle))
+    {
+        /* calculating address, stores are written to memory at commit */
+        instr.execute();
+        if ( instr.is_store())
+        {
+            is_bubble = false;
+            caches->get_l1d().write( instr.get_mem_addr());
+            complete( instr, cycle);
+            if constexpr ( trace_enabled)
+                sout << "memory  cycle " << std::dec << cycle << ": " << instr << std::endl;
+            continue;
+        }
+
+        /* older loads have priority in the cache access */
+        Load load;
+        load.instr = instr;
+        const auto is_older = []( const Load& a, const Load& b) {
+            return a.instr.get_sequence_id() < b.instr.get_sequence_id();
+        };
+        loads.insert( std::upper_bound( loads.begin(), loads.end(), load, is_older), load);
+    }
+
+    for ( auto it = loads.begin(); it != loads.end(); )
+    {
+        if ( !it->access.clock( &caches->get_l1d(), it->instr, cycle))
+        {
+            ++it;
+            continue;
+        }
+
+        is_bubble = false;
+        memory->load( &it->instr);
+        complete( it->instr, cycle);
+        if constexpr ( trace_enabled)
+            sout << "memory  cycle " << std::dec << cycle << ": " << it->instr << std::endl;
+
+        it = loads.erase( it);
+    }
+
+    if constexpr ( trace_enabled)
+        if ( is_bubble)
+            sout << "memory  cycle " << std::dec << cycle << ": bubble\n";
+}
+
+void OoOMIPS::clock_commit( Cycles cycle)
+{
+    bool is_bubble = true;
+    for ( uint32 i = 0; i < width && !rob.empty(); ++i)
+    {
+        auto& entry = rob.front();
+        if ( !entry.is_complete || entry.complete_cycle == cycle)
+            break;
+
+        is_bubble = false;
+        auto& instr = entry.instr;
+
+        /* reports unknown instruction */
+        if ( instr.is_unknown())
+            instr.execute();
+
+        /* update architectural state */
+        if ( instr.is_store())
+        {
+            memory->store( instr);
+            stores.pop_front();
+        }
+
+        if ( instr.get_dst_num() != REG_NUM_ZERO)
+            arch_regs.at( static_cast<size_t>( instr.get_dst_num())) = instr.get_v_dst();
+
+        rename_table.commit( instr);
+
+        /* check for traps */
+        instr.check_trap();
+
+        if constexpr ( trace_enabled)
+            sout << "commit  cycle " << std::dec << cycle << ": " << instr << std::endl;
+
+        check( instr);
+
+        ++executed_instrs;
+        last_commit_cycle = cycle;
+
+        fetch_unit->update( instr);
+
+        const bool is_misprediction = instr.is_misprediction();
+        const Addr target = instr.get_new_PC();
+        rob.pop_front();
+
+        /* the rest of reorder buffer is on the wrong path */
+        if ( is_misprediction)
+        {
+            flush( target, cycle);
+            break;
+        }
+    }
+
+    if ( is_bubble)
+    {
+        if constexpr ( trace_enabled)
+            sout << "commit  cycle " << std::dec << cycle << ": bubble\n";
+        if ( cycle - last_commit_cycle >= deadlock_cycles)
+        {
+            serr << "Deadlock was detected. The process will be aborted."
+                 << std::endl << std::endl << critical;
+        }
+    }
+}
+
+void OoOMIPS::flush( Addr target, Cycles cycle)
+{
+    rob.clear();
+    alu_queue.clear();
+    mem_queue.clear();
+    stores.clear();
+    rename_table.clear();
+
+    wp_commit_2_all_flush->write( true, cycle);
+    wp_commit_2_fetch_target->write( target, cycle);
+
+    if constexpr ( trace_enabled)
+        sout << "commit  cycle " << std::dec << cycle << ": misprediction\n";
+}
+
+void OoOMIPS::check( const FuncInstr& instr)
+{
+    const std::string func_dump = checker.step();
+
+    if ( func_dump != instr.Dump())
+        serr << "****************************" << std::endl
+             << "Mismatch: " << std::endl
+             << "Checker output: " << func_dump    << std::endl
+             << "PerfSim output: " << instr.Dump() << std::endl
+             << critical;
+}
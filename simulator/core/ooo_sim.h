@@ -0,0 +1,135 @@
+/*
+ * ooo_sim.h - out-of-order mips performance simulator
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef OOO_SIM_H
+#define OOO_SIM_H
+
+#include <array>
+#include <deque>
+#include <memory>
+#include <string>
+
+#include <infra/log.h>
+#include <infra/ports/ports.h>
+
+#include "func_sim/func_sim.h"
+#include "mips/mips_instr.h"
+#include "mips/mips_memory.h"
+
+#include "cache/cache_hierarchy.h"
+
+#include "data_cache_read.h"
+#include "fetch_unit.h"
+#include "issue_queue.h"
+#include "rename_table.h"
+#include "reorder_buffer.h"
+
+/*
+ * Pipeline is:
+ *     fetch -> rename -> issue -> execute (ALU) or memory -> commit
+ * Rename allocates reorder buffer entry and places instruction
+ * to ALU or memory issue queue. Results are written to the reorder buffer,
+ * waking up the dependent instructions, and the architectural state
+ * is updated at commit in program order.
+ * Mispredicted branch flushes the whole pipeline when it is committed.
+ * Data cache is non-blocking, so loads missed in it do not hold
+ * the memory unit, and independent misses overlap.
+ */
+class OoOMIPS : protected Log
+{
+private:
+    Cycles executed_instrs = 0;
+    Cycles cycles = 0; // duration of the last run
+    Cycles last_commit_cycle = 0; // to handle possible deadlocks
+    Cycles deadlock_cycles = 0;
+    static const uint32 PIPELINE_DEPTH = 6; // fetch, rename, issue, execute, memory, commit
+
+    /* number of instructions processed by each stage per cycle */
+    const uint32 width;
+
+    /* rename stage variables */
+    std::deque<IfIdData> rename_data = {}; // the rest of fetch group to rename
+
+    /* loads waiting for data cache, in program order */
+    struct Load
+    {
+        FuncInstr instr = {};
+        DataCacheRead access = {};
+    };
+    std::deque<Load> loads = {};
+
+    /* simulator units */
+    std::array<uint32, REG_NUM_MAX> arch_regs = {}; // committed state
+    RenameTable rename_table = {};
+    ReorderBuffer rob;
+    IssueQueue alu_queue;
+    IssueQueue mem_queue;
+    std::deque<uint64> stores = {}; // uncommitted stores in program order
+    uint64 sequence_id = 0; // counter of renamed instructions
+
+    std::unique_ptr<MIPSMemory> memory = nullptr;
+    std::unique_ptr<CacheHierarchy> caches = nullptr;
+    std::unique_ptr<FetchUnit> fetch_unit = nullptr;
+
+    /* MIPS functional simulator for internal checks */
+    MIPS checker;
+    void check( const FuncInstr& instr);
+
+    /* all ports */
+    std::unique_ptr<WritePort<IfIdData>> wp_fetch_2_rename = nullptr;
+    std::unique_ptr<ReadPort<IfIdData>> rp_fetch_2_rename = nullptr;
+    std::unique_ptr<WritePort<bool>> wp_rename_2_fetch_stall = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_rename_2_fetch_stall = nullptr;
+
+    std::unique_ptr<WritePort<FuncInstr>> wp_issue_2_execute = nullptr;
+    std::unique_ptr<ReadPort<FuncInstr>> rp_issue_2_execute = nullptr;
+    std::unique_ptr<WritePort<FuncInstr>> wp_issue_2_memory = nullptr;
+    std::unique_ptr<ReadPort<FuncInstr>> rp_issue_2_memory = nullptr;
+
+    std::unique_ptr<WritePort<bool>> wp_commit_2_all_flush = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_fetch_flush = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_rename_flush = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_execute_flush = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_memory_flush = nullptr;
+
+    std::unique_ptr<WritePort<Addr>> wp_commit_2_fetch_target = nullptr;
+    std::unique_ptr<ReadPort<Addr>> rp_commit_2_fetch_target = nullptr;
+
+    /* captures value of the source if it is ready */
+    bool wakeup( IssueQueue::Source* source);
+    bool is_ready( IssueQueue::Entry* entry);
+    IssueQueue::Source rename_source( RegNum num);
+
+    /* writes result to the reorder buffer */
+    void complete( const FuncInstr& instr, Cycles cycle);
+
+    /* drops all the instructions after the committed one */
+    void flush( Addr target, Cycles cycle);
+
+    /* main stages functions */
+    void clock_fetch( Cycles cycle);
+    void clock_rename( Cycles cycle);
+    void clock_execute( Cycles cycle);
+    void clock_memory( Cycles cycle);
+    void clock_issue( Cycles cycle);
+    void clock_commit( Cycles cycle);
+
+public:
+    explicit OoOMIPS( bool log);
+    ~OoOMIPS() final;
+
+    /* forbid copies */
+    OoOMIPS& operator=( const OoOMIPS&) = delete;
+    OoOMIPS( const OoOMIPS&) = delete;
+
+    void run( const std::string& tr,
+              uint64 instrs_to_run);
+
+    /* statistics of the last run */
+    Cycles get_cycles() const { return cycles; }
+    uint64 get_executed_instrs() const { return executed_instrs; }
+};
+
+#endif // OOO_SIM_H
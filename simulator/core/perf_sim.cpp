@@ -8,35 +8,44 @@
 #include <mips/mips_memory.h>
 #include <mips/mips_rf.h>
 
+#include "core_config.h"
 #include "perf_sim.h"
 
 static const uint32 PORT_LATENCY = 1;
+static const uint32 STALL_PORT_LATENCY = 0;
 static const uint32 PORT_FANOUT = 1;
 static const uint32 PORT_BW = 1;
 static const uint32 FLUSHED_STAGES_NUM = 4;
 
 namespace config {
-    static Value<std::string> bp_mode = { "bp-mode", "dynamic_two_bit", "branch prediction mode"};
-    static Value<uint32> bp_size = { "bp-size", 128, "BTB size in entries"};
-    static Value<uint32> bp_ways = { "bp-ways", 16, "number of ways in BTB"};
+    static Value<std::string> forwarding_paths = { "forwarding", "execute,memory", "forwarding paths: execute, memory, or none"};
+
 } // namespace config
 
-PerfMIPS::PerfMIPS(bool log) : Log( log), rf( new RF), checker( false)
+PerfMIPS::PerfMIPS(bool log) : Log( log), width( config::width), rf( new RF), checker( false)
 {
     executed_instrs = 0;
 
-    wp_fetch_2_decode = make_write_port<IfIdData>("FETCH_2_DECODE", PORT_BW, PORT_FANOUT);
+    if ( width == 0)
+        serr << "ERROR: Wrong arguments! Pipeline width should be greater than zero"
+             << std::endl << critical;
+
+    wp_fetch_2_decode = make_write_port<IfIdData>("FETCH_2_DECODE", width, PORT_FANOUT);
     rp_fetch_2_decode = make_read_port<IfIdData>("FETCH_2_DECODE", PORT_LATENCY);
     wp_decode_2_fetch_stall = make_write_port<bool>("DECODE_2_FETCH_STALL", PORT_BW, PORT_FANOUT);
     rp_decode_2_fetch_stall = make_read_port<bool>("DECODE_2_FETCH_STALL", PORT_LATENCY);
 
-    wp_decode_2_execute = make_write_port<FuncInstr>("DECODE_2_EXECUTE", PORT_BW, PORT_FANOUT);
+    wp_decode_2_execute = make_write_port<FuncInstr>("DECODE_2_EXECUTE", width, PORT_FANOUT);
     rp_decode_2_execute = make_read_port<FuncInstr>("DECODE_2_EXECUTE", PORT_LATENCY);
+    wp_execute_2_decode_stall = make_write_port<bool>("EXECUTE_2_DECODE_STALL", PORT_BW, PORT_FANOUT);
+    rp_execute_2_decode_stall = make_read_port<bool>("EXECUTE_2_DECODE_STALL", STALL_PORT_LATENCY);
 
-    wp_execute_2_memory = make_write_port<FuncInstr>("EXECUTE_2_MEMORY", PORT_BW, PORT_FANOUT);
+    wp_execute_2_memory = make_write_port<FuncInstr>("EXECUTE_2_MEMORY", width, PORT_FANOUT);
     rp_execute_2_memory = make_read_port<FuncInstr>("EXECUTE_2_MEMORY", PORT_LATENCY);
+    wp_memory_2_execute_stall = make_write_port<bool>("MEMORY_2_EXECUTE_STALL", PORT_BW, PORT_FANOUT);
+    rp_memory_2_execute_stall = make_read_port<bool>("MEMORY_2_EXECUTE_STALL", STALL_PORT_LATENCY);
 
-    wp_memory_2_writeback = make_write_port<FuncInstr>("MEMORY_2_WRITEBACK", PORT_BW, PORT_FANOUT);
+    wp_memory_2_writeback = make_write_port<FuncInstr>("MEMORY_2_WRITEBACK", width, PORT_FANOUT);
     rp_memory_2_writeback = make_read_port<FuncInstr>("MEMORY_2_WRITEBACK", PORT_LATENCY);
 
     /* branch misprediction unit ports */
@@ -49,9 +58,13 @@ PerfMIPS::PerfMIPS(bool log) : Log( log), rf( new RF), checker( false)
     wp_memory_2_fetch_target = make_write_port<Addr>("MEMORY_2_FETCH_TARGET", PORT_BW, PORT_FANOUT);
     rp_memory_2_fetch_target = make_read_port<Addr>("MEMORY_2_FETCH_TARGET", PORT_LATENCY);
 
-    BPFactory bp_factory;
-    bp = bp_factory.create( config::bp_mode, config::bp_size, config::bp_ways);
-    
+    forwarding = std::make_unique<Forwarding>( *rf, config::forwarding_paths);
+
+    caches = std::make_unique<CacheHierarchy>();
+    fetch_unit = std::make_unique<FetchUnit>( log, width, &caches->get_l1i());
+
+    deadlock_cycles = get_deadlock_cycles( *caches, PIPELINE_DEPTH);
+
     init_ports();
 }
 
@@ -61,32 +74,46 @@ void PerfMIPS::run( const std::string& tr,
     assert( instrs_to_run < MAX_VAL32);
     Cycles cycle = 0;
 
-    is_anything_to_decode = false;
+    decode_data.clear();
+    execute_data.clear();
+    memory_data.clear();
+    is_memory_started = false;
 
     memory = new MIPSMemory( tr);
 
     checker.init( tr);
 
-    new_PC = memory->startPC();
+    fetch_unit->init( memory);
 
     boost::timer::cpu_timer timer;
 
+    /*
+     * Stages are clocked from the end of the pipeline, so stall signals
+     * reach preceding stages in the same cycle.
+     */
     while (executed_instrs < instrs_to_run)
     {
+        caches->clock( cycle);
         clock_writeback( cycle);
-        clock_fetch( cycle);
-        clock_decode( cycle);
-        clock_execute( cycle);
         clock_memory( cycle);
+        clock_execute( cycle);
+        clock_decode( cycle);
+        clock_fetch( cycle);
         ++cycle;
 
-        sout << "Executed instructions: " << executed_instrs
-             << std::endl << std::endl;
+        if constexpr ( trace_enabled)
+            sout << "Executed instructions: " << std::dec << executed_instrs
+                 << std::endl << std::endl;
 
         check_ports( cycle);
     }
 
+    cycles = cycle;
     auto time = timer.elapsed().wall;
+
+    /* buffered log should be printed before the statistics */
+    LogSink::drain();
+
     auto frequency = 1e6 * cycle / time;
     auto ipc = 1.0 * executed_instrs / cycle;
     auto simips = 1e6 * executed_instrs / time;
@@ -96,8 +123,11 @@ void PerfMIPS::run( const std::string& tr,
               << std::endl << "IPC:      " << ipc
               << std::endl << "sim freq: " << frequency << " kHz"
               << std::endl << "sim IPS:  " << simips    << " kips"
-              << std::endl << "****************************"
               << std::endl;
+
+    caches->dump_statistics( std::cout);
+
+    std::cout << "****************************" << std::endl;
 }
 
 void PerfMIPS::clock_fetch( int cycle)
@@ -109,135 +139,175 @@ void PerfMIPS::clock_fetch( int cycle)
     bool is_stall = false;
     rp_decode_2_fetch_stall->read( &is_stall, cycle);
 
-    /* updating PC */
     if ( is_flush)
-        rp_memory_2_fetch_target->read( &PC, cycle); // fixing PC
-    else if ( !is_stall)
-        PC = new_PC;
-
-    /* creating structure to be sent to decode stage */
-    IfIdData data;
-
-    /* fetching instruction */
-    data.raw = memory->fetch( PC);
-
-    /* saving predictions and updating PC according to them */
-    data.PC = PC;
-    data.predicted_taken = bp->is_taken( PC);
-    data.predicted_target = bp->get_target( PC);
-
-    /* updating PC according to prediction */
-    new_PC = data.predicted_target;
-
-    /* sending to decode */
-    wp_fetch_2_decode->write( data, cycle);
+    {
+        Addr target = NO_VAL32;
+        rp_memory_2_fetch_target->read( &target, cycle);
+        fetch_unit->flush( target);
+    }
 
-    /* log */
-    sout << "fetch   cycle " << std::dec << cycle << ": 0x"
-         << std::hex << PC << ": 0x" << data.raw << std::endl;
+    fetch_unit->clock( is_stall, wp_fetch_2_decode.get(), cycle);
 }
 
 void PerfMIPS::clock_decode( int cycle) {
-    sout << "decode  cycle " << std::dec << cycle << ": ";
-
-    /* receive flush signal */
+    /* receive flush and stall signals */
     bool is_flush = false;
     rp_decode_flush->read( &is_flush, cycle);
 
+    bool is_stall = false;
+    rp_execute_2_decode_stall->read( &is_stall, cycle);
+
     /* branch misprediction */
     if ( is_flush)
     {
-        /* ignoring the upcoming instruction as it is invalid */
-        rp_fetch_2_decode->read( &decode_data, cycle);
+        /* ignoring the upcoming instructions as they are invalid */
+        IfIdData data;
+        while ( rp_fetch_2_decode->read( &data, cycle))
+            ;
 
-        is_anything_to_decode = false;
-        sout << "flush\n";
+        decode_data.clear();
+        if constexpr ( trace_enabled)
+            sout << "decode  cycle " << std::dec << cycle << ": flush\n";
         return;
     }
 
-    if ( !is_anything_to_decode)
+    IfIdData data;
+    if ( decode_data.empty())
     {
         /* acquiring data from fetch */
-        is_anything_to_decode = rp_fetch_2_decode->read( &decode_data, cycle);
+        while ( rp_fetch_2_decode->read( &data, cycle))
+            decode_data.push_back( data);
     }
     else
     {
         /* ignore data from port -- to suppress loss messages */
-        IfIdData data;
-        rp_fetch_2_decode->read( &data, cycle);
+        while ( rp_fetch_2_decode->read( &data, cycle))
+            ;
     }
 
     /* check if there is something to process */
-    if ( !is_anything_to_decode)
+    if ( decode_data.empty())
     {
-        sout << "bubble\n";
+        if constexpr ( trace_enabled)
+            sout << "decode  cycle " << std::dec << cycle << ": bubble\n";
         return;
     }
 
-    FuncInstr instr( decode_data.raw,
-                     decode_data.PC,
-                     decode_data.predicted_taken,
-                     decode_data.predicted_target);
+    /* execute stage is busy, keep instructions */
+    if ( is_stall)
+    {
+        wp_decode_2_fetch_stall->write( true, cycle);
+        if constexpr ( trace_enabled)
+            sout << "decode  cycle " << std::dec << cycle << ": stall\n";
+        return;
+    }
 
-    /* TODO: replace all this code by introducing Forwarding unit */
-    if ( rf->check_sources( instr))
+    /* instructions are decoded in program order, so dependencies
+     * inside of fetch group are resolved by the register file as well */
+    while ( !decode_data.empty())
     {
+        const auto& front = decode_data.front();
+        FuncInstr instr( front.raw,
+                         front.PC,
+                         front.predicted_taken,
+                         front.predicted_target);
+
+        if constexpr ( trace_enabled)
+            sout << "decode  cycle " << std::dec << cycle << ": ";
+
+        /* sources have to be bypassed in time, or read from RF */
+        if ( !forwarding->check_sources( instr, cycle)) // data hazard, stalling pipeline
+        {
+            wp_decode_2_fetch_stall->write( true, cycle);
+            if constexpr ( trace_enabled)
+                sout << instr << " (data hazard)\n";
+            return;
+        }
+
         rf->read_sources( &instr);
 
-        is_anything_to_decode = false; // successfully decoded
+        instr.set_sequence_id( sequence_id++);
+        forwarding->issue( instr, cycle);
+
+        decode_data.pop_front(); // successfully decoded
 
         wp_decode_2_execute->write( instr, cycle);
 
         /* log */
-        sout << instr << std::endl;
-    }
-    else // data hazard, stalling pipeline
-    {
-        wp_decode_2_fetch_stall->write( true, cycle);
-        sout << instr << " (data hazard)\n";
+        if constexpr ( trace_enabled)
+            sout << instr << std::endl;
     }
 }
 
 void PerfMIPS::clock_execute( int cycle)
 {
-    sout << "execute cycle " << std::dec << cycle << ": ";
-
     FuncInstr instr;
 
-    /* receive flush signal */
+    /* receive flush and stall signals */
     bool is_flush = false;
     rp_execute_flush->read( &is_flush, cycle);
 
+    bool is_stall = false;
+    rp_memory_2_execute_stall->read( &is_stall, cycle);
+
     /* branch misprediction */
     if ( is_flush)
     {
-        /* ignoring the upcoming instruction as it is invalid */
-        rp_decode_2_execute->read( &instr, cycle);
-        rf->cancel( instr);
-        sout << "flush\n";
+        /* ignoring the upcoming instructions as they are invalid */
+        while ( rp_decode_2_execute->read( &instr, cycle))
+            cancel( instr);
+
+        for ( const auto& held : execute_data)
+            cancel( held);
+
+        execute_data.clear();
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": flush\n";
         return;
     }
 
+    /* decode stage does not send anything while instructions are held */
+    while ( rp_decode_2_execute->read( &instr, cycle))
+    {
+        /* acquiring bypassed sources */
+        forwarding->read_sources( &instr);
+
+        /* preform execution */
+        instr.execute();
+        forwarding->execute( instr, cycle);
+
+        execute_data.push_back( instr);
+
+        /* log */
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": " << instr << std::endl;
+    }
+
     /* check if there is something to process */
-    if ( !rp_decode_2_execute->read( &instr, cycle))
+    if ( execute_data.empty())
     {
-        sout << "bubble\n";
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": bubble\n";
         return;
     }
 
-    /* preform execution */
-    instr.execute();
+    /* memory stage is busy, keep instructions */
+    if ( is_stall)
+    {
+        wp_execute_2_decode_stall->write( true, cycle);
+        if constexpr ( trace_enabled)
+            sout << "execute cycle " << std::dec << cycle << ": stall\n";
+        return;
+    }
 
-    wp_execute_2_memory->write( instr, cycle);
+    for ( const auto& executed : execute_data)
+        wp_execute_2_memory->write( executed, cycle);
 
-    /* log */
-    sout << instr << std::endl;
+    execute_data.clear();
 }
 
 void PerfMIPS::clock_memory( int cycle)
 {
-    sout << "memory  cycle " << std::dec << cycle << ": ";
-
     FuncInstr instr;
 
     /* receieve flush signal */
@@ -247,81 +317,142 @@ void PerfMIPS::clock_memory( int cycle)
     /* branch misprediction */
     if ( is_flush)
     {
-        /* ignoring the upcoming instruction as it is invalid */
-        rp_execute_2_memory->read( &instr, cycle);
-        rf->cancel( instr);
-        sout << "flush\n";
+        /* ignoring the upcoming instructions as they are invalid */
+        while ( rp_execute_2_memory->read( &instr, cycle))
+            cancel( instr);
+
+        for ( const auto& held : memory_data)
+            cancel( held);
+
+        memory_data.clear();
+        is_memory_started = false;
+        if constexpr ( trace_enabled)
+            sout << "memory  cycle " << std::dec << cycle << ": flush\n";
         return;
     }
 
+    /* execute stage does not send anything while instructions are held */
+    while ( rp_execute_2_memory->read( &instr, cycle))
+        memory_data.push_back( instr);
+
     /* check if there is something to process */
-    if ( !rp_execute_2_memory->read( &instr, cycle))
+    if ( memory_data.empty())
     {
-        sout << "bubble\n";
+        if constexpr ( trace_enabled)
+            sout << "memory  cycle " << std::dec << cycle << ": bubble\n";
         return;
     }
 
-    /* acquiring real information */
-    bool actually_taken = instr.is_jump_taken();
-    Addr real_target = instr.get_new_PC();
-
-    /* branch misprediction unit */
-    if ( instr.is_misprediction())
+    bool is_misprediction = false;
+    while ( !memory_data.empty())
     {
-        /* updating BTB */
-        bp->update( actually_taken, instr.get_PC(), real_target);
+        auto& front = memory_data.front();
 
-        /* flushing the pipeline */
-        wp_memory_2_all_flush->write( true, cycle);
+        /* instructions after mispredicted one are on the wrong path */
+        if ( is_misprediction)
+        {
+            cancel( front);
+            memory_data.pop_front();
+            continue;
+        }
 
-        /* sending valid PC to fetch stage */
-        wp_memory_2_fetch_target->write( real_target, cycle);
+        /* the first cycle of instruction in memory stage */
+        if ( !is_memory_started)
+        {
+            fetch_unit->update( front);
 
-        sout << "misprediction\n";
-    }
+            /* branch misprediction unit */
+            if ( front.is_misprediction())
+            {
+                is_misprediction = true;
 
-    /* perform required loads and stores */
-    memory->load_store( &instr);
+                /* flushing the pipeline */
+                wp_memory_2_all_flush->write( true, cycle);
 
-    wp_memory_2_writeback->write( instr, cycle);
+                /* sending valid PC to fetch stage */
+                wp_memory_2_fetch_target->write( front.get_new_PC(), cycle);
 
-    /* log */
-    sout << instr << std::endl;
+                if constexpr ( trace_enabled)
+                    sout << "memory  cycle " << std::dec << cycle << ": misprediction\n";
+            }
+
+            /* perform required loads and stores */
+            memory->load_store( &front);
+            is_memory_started = true;
+
+            /* stores are retired through write buffer, so they do not wait for cache */
+            if ( front.is_load())
+                load = DataCacheRead();
+            else if ( front.is_store())
+                caches->get_l1d().write( front.get_mem_addr());
+        }
+
+        /* cache access is not completed, stalling pipeline */
+        if ( front.is_load() && !load.clock( &caches->get_l1d(), front, cycle))
+        {
+            wp_memory_2_execute_stall->write( true, cycle);
+            if constexpr ( trace_enabled)
+                sout << "memory  cycle " << std::dec << cycle << ": " << front << " (cache miss)\n";
+            return;
+        }
+
+        is_memory_started = false;
+        forwarding->complete( front, cycle);
+
+        wp_memory_2_writeback->write( front, cycle);
+
+        /* log */
+        if constexpr ( trace_enabled)
+            sout << "memory  cycle " << std::dec << cycle << ": " << front << std::endl;
+
+        memory_data.pop_front();
+    }
 }
 
 void PerfMIPS::clock_writeback( int cycle)
 {
-    sout << "wb      cycle " << std::dec << cycle << ": ";
-
     FuncInstr instr;
 
     /* check if there is something to process */
-    if ( !rp_memory_2_writeback->read( &instr, cycle))
+    bool is_bubble = true;
+    while ( rp_memory_2_writeback->read( &instr, cycle))
+    {
+        is_bubble = false;
+
+        /* perform writeback */
+        rf->write_dst( instr);
+
+        /* check for traps */
+        instr.check_trap();
+
+        /* log */
+        if constexpr ( trace_enabled)
+            sout << "wb      cycle " << std::dec << cycle << ": " << instr << std::endl;
+
+        /* perform checks */
+        check( instr);
+
+        /* update simulator cycles info */
+        ++executed_instrs;
+        last_writeback_cycle = cycle;
+    }
+
+    if ( is_bubble)
     {
-        sout << "bubble\n";
-        if ( cycle - last_writeback_cycle >= 10)
+        if constexpr ( trace_enabled)
+            sout << "wb      cycle " << std::dec << cycle << ": bubble\n";
+        if ( cycle - last_writeback_cycle >= deadlock_cycles)
         {
             serr << "Deadlock was detected. The process will be aborted."
                  << std::endl << std::endl << critical;
         }
-        return;
     }
+}
 
-    /* perform writeback */
-    rf->write_dst( instr);
-
-    /* check for traps */
-    instr.check_trap();
-
-    /* log */
-    sout << instr << std::endl;
-
-    /* perform checks */
-    check( instr);
-
-    /* update simulator cycles info */
-    ++executed_instrs;
-    last_writeback_cycle = cycle;
+void PerfMIPS::cancel( const FuncInstr& instr)
+{
+    rf->cancel( instr);
+    forwarding->cancel( instr);
 }
 
 void PerfMIPS::check( const FuncInstr& instr)
@@ -335,4 +466,3 @@ void PerfMIPS::check( const FuncInstr& instr)
              << "PerfSim output: " << instr.Dump() << std::endl
              << critical;
 }
-
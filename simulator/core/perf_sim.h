@@ -6,6 +6,8 @@
 #ifndef PERF_SIM_H
 #define PERF_SIM_H
 
+#include <deque>
+#include <vector>
 #include <iostream>
 #include <sstream>
 #include <iomanip>
@@ -17,32 +19,42 @@
 #include "mips/mips_instr.h"
 #include "mips/mips_rf.h"
 
-#include "bpu/bpu.h"
+#include "cache/cache_hierarchy.h"
+
+#include "data_cache_read.h"
+#include "fetch_unit.h"
+#include "forwarding.h"
 
 class PerfMIPS : protected Log
 {
 private:
     Cycles executed_instrs = 0;
+    Cycles cycles = 0; // duration of the last run
     Cycles last_writeback_cycle = 0; // to handle possible deadlocks
+    Cycles deadlock_cycles = 0;
+    static const uint32 PIPELINE_DEPTH = 5; // fetch, decode, execute, memory, writeback
 
-    /* the struture of data sent from fetch to decode stage */
-    struct IfIdData {
-        bool predicted_taken = false;     // Predicted direction
-        Addr predicted_target = NO_VAL32; // PC, predicted by BPU
-        Addr PC = NO_VAL32;               // current PC
-        uint32 raw = NO_VAL32;            // fetched instruction code
-    };
+    /* number of instructions processed by each stage per cycle */
+    const uint32 width;
 
     /* decode stage variables */
-    IfIdData decode_data = {};
-    bool is_anything_to_decode = false;
+    std::deque<IfIdData> decode_data = {}; // the rest of fetch group to decode
+
+    /* execute stage variables */
+    std::vector<FuncInstr> execute_data = {}; // executed instructions held by memory stall
+
+    /* memory stage variables */
+    std::deque<FuncInstr> memory_data = {}; // instructions waiting for cache
+    bool is_memory_started = false;         // the first one is resolved and sent to cache
+    DataCacheRead load = {};                // data cache access of the first one if it is a load
 
     /* simulator units */
     RF* rf = nullptr;
-    Addr PC = NO_VAL32;
-    Addr new_PC = NO_VAL32;
+    std::unique_ptr<Forwarding> forwarding = nullptr;
+    uint64 sequence_id = 0; // counter of decoded instructions
     MIPSMemory* memory = nullptr;
-    std::unique_ptr<BaseBP> bp = nullptr;
+    std::unique_ptr<CacheHierarchy> caches = nullptr;
+    std::unique_ptr<FetchUnit> fetch_unit = nullptr;
 
     /* MIPS functional simulator for internal checks */
     MIPS checker;
@@ -56,9 +68,13 @@ private:
 
     std::unique_ptr<WritePort<FuncInstr>> wp_decode_2_execute = nullptr;
     std::unique_ptr<ReadPort<FuncInstr>> rp_decode_2_execute = nullptr;
+    std::unique_ptr<WritePort<bool>> wp_execute_2_decode_stall = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_execute_2_decode_stall = nullptr;
 
     std::unique_ptr<WritePort<FuncInstr>> wp_execute_2_memory = nullptr;
     std::unique_ptr<ReadPort<FuncInstr>> rp_execute_2_memory = nullptr;
+    std::unique_ptr<WritePort<bool>> wp_memory_2_execute_stall = nullptr;
+    std::unique_ptr<ReadPort<bool>> rp_memory_2_execute_stall = nullptr;
 
 
     std::unique_ptr<WritePort<FuncInstr>> wp_memory_2_writeback = nullptr;
@@ -73,6 +89,9 @@ private:
     std::unique_ptr<WritePort<Addr>> wp_memory_2_fetch_target = nullptr;
     std::unique_ptr<ReadPort<Addr>> rp_memory_2_fetch_target = nullptr;
 
+    /* drops instruction from the pipeline */
+    void cancel( const FuncInstr& instr);
+
     /* main stages functions */
     void clock_fetch( int cycle);
     void clock_decode( int cycle);
@@ -90,6 +109,10 @@ public:
 
     void run( const std::string& tr,
               uint64 instrs_to_run);
+
+    /* statistics of the last run */
+    Cycles get_cycles() const { return cycles; }
+    uint64 get_executed_instrs() const { return executed_instrs; }
 };
 
 #endif
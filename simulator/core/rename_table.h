@@ -0,0 +1,52 @@
+/*
+ * rename_table.h - register alias table of out-of-order MIPS core
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef RENAME_TABLE_H
+#define RENAME_TABLE_H
+
+#include <array>
+
+#include <infra/types.h>
+
+#include <mips/mips_instr.h>
+
+/*
+ * Maps each architectural register to the reorder buffer entry
+ * of its youngest in-flight producer. NO_VAL64 means that
+ * the value is already committed to the architectural register file.
+ */
+class RenameTable
+{
+    std::array<uint64, REG_NUM_MAX> producers = {};
+
+    uint64& get_entry( RegNum num) { return producers.at( static_cast<size_t>( num)); }
+    const uint64& get_entry( RegNum num) const { return producers.at( static_cast<size_t>( num)); }
+
+public:
+    RenameTable() { clear(); }
+
+    uint64 get_producer( RegNum num) const { return get_entry( num); }
+
+    void rename( const FuncInstr& instr)
+    {
+        if ( instr.get_dst_num() != REG_NUM_ZERO)
+            get_entry( instr.get_dst_num()) = instr.get_sequence_id();
+    }
+
+    /* register keeps its alias if there is a younger producer */
+    void commit( const FuncInstr& instr)
+    {
+        if ( instr.get_dst_num() == REG_NUM_ZERO)
+            return;
+
+        auto& entry = get_entry( instr.get_dst_num());
+        if ( entry == instr.get_sequence_id())
+            entry = NO_VAL64;
+    }
+
+    void clear() { producers.fill( NO_VAL64); }
+};
+
+#endif // RENAME_TABLE_H
@@ -0,0 +1,82 @@
+/*
+ * reorder_buffer.h - reorder buffer of out-of-order MIPS core
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef REORDER_BUFFER_H
+#define REORDER_BUFFER_H
+
+#include <cassert>
+#include <vector>
+
+#include <infra/types.h>
+
+#include <mips/mips_instr.h>
+
+/*
+ * Circular buffer keeping instructions in program order from rename till commit.
+ * Instructions are allocated with consecutive sequence ids,
+ * so an entry is found by the id of its instruction.
+ */
+class ReorderBuffer
+{
+public:
+    struct Entry
+    {
+        FuncInstr instr = {};
+        bool is_complete = false;
+        Cycles complete_cycle = 0;
+    };
+
+private:
+    std::vector<Entry> entries;
+    uint64 head_id = 0; // sequence id of the oldest instruction
+    size_t count = 0;
+
+    Entry& get_entry( uint64 id) { return entries[ id % entries.size()]; }
+
+public:
+    explicit ReorderBuffer( size_t size) : entries( size) { }
+
+    bool empty() const { return count == 0; }
+    bool is_full() const { return count == entries.size(); }
+
+    void allocate( const FuncInstr& instr)
+    {
+        assert( !is_full());
+        if ( empty())
+            head_id = instr.get_sequence_id();
+
+        assert( instr.get_sequence_id() == head_id + count);
+        auto& entry = get_entry( instr.get_sequence_id());
+        entry.instr = instr;
+        entry.is_complete = false;
+        ++count;
+    }
+
+    /* returns nullptr if instruction has left the buffer */
+    Entry* find( uint64 id)
+    {
+        if ( id < head_id || id >= head_id + count)
+            return nullptr;
+
+        return &get_entry( id);
+    }
+
+    Entry& front()
+    {
+        assert( !empty());
+        return get_entry( head_id);
+    }
+
+    void pop_front()
+    {
+        assert( !empty());
+        ++head_id;
+        --count;
+    }
+
+    void clear() { count = 0; }
+};
+
+#endif // REORDER_BUFFER_H
@@ -2,10 +2,18 @@
 #include <cassert>
 #include <cstdlib>
 
+// generic C++
+#include <vector>
+
 // Google Test library
 #include <gtest/gtest.h>
 
 // Module
+#include <infra/config/config.h>
+
+#include "../forwarding.h"
+#include "../front_end_predictor.h"
+#include "../ooo_sim.h"
 #include "../perf_sim.h"
 
 static const std::string valid_elf_file = TEST_PATH;
@@ -14,6 +22,26 @@ static const int64 num_steps = 2013;
 #define GTEST_ASSERT_NO_DEATH(statement) \
     ASSERT_EXIT({{ statement } ::exit(EXIT_SUCCESS); }, ::testing::ExitedWithCode(0), "")
 
+/* Sets options for the test, other options get their default values */
+static void handle_args( std::vector<const char*> args)
+{
+    args.insert( args.begin(), "mipt-mips");
+    config::handleArgs( args.size(), const_cast<char**>( args.data())); // NOLINT
+}
+
+/* Runs the trace with the options and returns number of cycles */
+template<typename Model>
+static Cycles run_with_args( const std::vector<const char*>& args)
+{
+    handle_args( args);
+    Model mips( false);
+    mips.run( valid_elf_file, num_steps);
+    handle_args( {});
+
+    EXPECT_GE( mips.get_executed_instrs(), static_cast<uint64>( num_steps));
+    return mips.get_cycles();
+}
+
 TEST( Perf_Sim_init, Process_Correct_Args_Of_Constr)
 {
     // Just call a constructor
@@ -36,9 +64,273 @@ TEST( Perf_Sim_init, Process_Wrong_Args)
 TEST( Perf_Sim, Run_Full_Trace)
 {
     PerfMIPS mips( false);
+    mips.run( valid_elf_file, num_steps);
+    ASSERT_EQ( mips.get_executed_instrs(), static_cast<uint64>( num_steps));
+    // scalar pipeline completes at most one instruction per cycle
+    ASSERT_GT( mips.get_cycles(), mips.get_executed_instrs());
+}
+
+TEST( Perf_Sim, Run_Full_Trace_Superscalar)
+{
+    const Cycles scalar = run_with_args<PerfMIPS>( {});
+    const Cycles superscalar = run_with_args<PerfMIPS>( { "--width", "4"});
+    ASSERT_LT( superscalar, scalar);
+}
+
+TEST( Perf_Sim, Run_Full_Trace_Without_Forwarding)
+{
+    const Cycles full = run_with_args<PerfMIPS>( {});
+    const Cycles execute_only = run_with_args<PerfMIPS>( { "--forwarding", "execute"});
+    const Cycles none = run_with_args<PerfMIPS>( { "--forwarding", "none"});
+    // loads are bypassed from memory stage only
+    ASSERT_LT( full, execute_only);
+    ASSERT_LT( execute_only, none);
+}
+
+TEST( Perf_Sim_init, Process_Wrong_Forwarding_Path)
+{
+    handle_args( { "--forwarding", "decode"});
+
+    ASSERT_EXIT( PerfMIPS mips( false), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    handle_args( {});
+}
+
+TEST( Perf_Sim, Run_Full_Trace_With_Small_Data_Cache)
+{
+    const Cycles large = run_with_args<PerfMIPS>( { "--width", "2"});
+    const Cycles small = run_with_args<PerfMIPS>( { "--dcache-size", "32", "--dcache-ways", "1", "--dcache-line-size", "16", "--width", "2"});
+    ASSERT_GT( small, large);
+}
+
+TEST( Perf_Sim, Run_Full_Trace_With_Small_Instruction_Cache)
+{
+    const Cycles large = run_with_args<PerfMIPS>( { "--width", "2"});
+    const Cycles small = run_with_args<PerfMIPS>( { "--icache-size", "64", "--icache-ways", "1", "--icache-line-size", "16", "--width", "2"});
+    ASSERT_GT( small, large);
+}
+
+TEST( Perf_Sim_init, Process_Wrong_Data_Cache_Latency)
+{
+    handle_args( { "--dcache-hit-latency", "0"});
+
+    ASSERT_EXIT( PerfMIPS mips( false), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    handle_args( {});
+}
+
+TEST( OoO_Sim_init, Process_Correct_Args_Of_Constr)
+{
+    OoOMIPS mips( false);
     GTEST_ASSERT_NO_DEATH( mips.run( valid_elf_file, num_steps); );
 }
 
+TEST( OoO_Sim_init, Process_Wrong_Sizes)
+{
+    handle_args( { "--rob-size", "0"});
+
+    ASSERT_EXIT( OoOMIPS mips( false), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    handle_args( {});
+}
+
+TEST( OoO_Sim, Run_Full_Trace)
+{
+    OoOMIPS mips( false);
+    mips.run( valid_elf_file, num_steps);
+    ASSERT_EQ( mips.get_executed_instrs(), static_cast<uint64>( num_steps));
+    ASSERT_GT( mips.get_cycles(), mips.get_executed_instrs());
+}
+
+TEST( OoO_Sim, Run_Full_Trace_Superscalar)
+{
+    const Cycles scalar = run_with_args<OoOMIPS>( {});
+    const Cycles superscalar = run_with_args<OoOMIPS>( { "--width", "4", "--rob-size", "64"});
+    ASSERT_LT( superscalar, scalar);
+}
+
+TEST( OoO_Sim, Run_Full_Trace_Small_Structures)
+{
+    const Cycles large = run_with_args<OoOMIPS>( { "--width", "2"});
+    const Cycles small = run_with_args<OoOMIPS>( { "--width", "2", "--rob-size", "3", "--iq-size", "1"});
+    ASSERT_GT( small, large);
+}
+
+TEST( OoO_Sim, Run_Full_Trace_With_Small_Data_Cache)
+{
+    const Cycles large = run_with_args<OoOMIPS>( { "--width", "2"});
+    const Cycles small = run_with_args<OoOMIPS>( { "--dcache-size", "32", "--dcache-ways", "1", "--dcache-line-size", "16",
+                                                    "--dcache-mshrs", "1", "--width", "2"});
+    ASSERT_GT( small, large);
+}
+
+/* addu $t0, $t1, $t2 */
+static FuncInstr producer( uint64 sequence_id)
+{
+    FuncInstr instr( 0x012a4021);
+    instr.set_sequence_id( sequence_id);
+    instr.set_v_src1( 2);
+    instr.set_v_src2( 3);
+    instr.execute();
+    return instr;
+}
+
+/* lw $t0, 0($t1) */
+static FuncInstr load( uint64 sequence_id)
+{
+    FuncInstr instr( 0x8d280000);
+    instr.set_sequence_id( sequence_id);
+    return instr;
+}
+
+/* addu $t3, $t0, $t0 */
+static const FuncInstr consumer( 0x01085821);
+
+TEST( Forwarding, Execute_Path)
+{
+    RF rf;
+    Forwarding forwarding( rf, "execute");
+    auto instr = producer( 1);
+    rf.read_sources( &instr);
+    forwarding.issue( instr, 10);
+
+    // result is bypassed from EX/MEM latch to the instruction decoded in the next cycle
+    ASSERT_FALSE( forwarding.check_sources( consumer, 10));
+    ASSERT_TRUE( forwarding.check_sources( consumer, 11));
+
+    forwarding.execute( instr, 11);
+    auto reader = consumer;
+    forwarding.read_sources( &reader);
+    reader.execute();
+    ASSERT_EQ( reader.get_v_dst(), 10u);
+}
+
+TEST( Forwarding, Memory_Path)
+{
+    RF rf;
+    Forwarding forwarding( rf, "memory");
+    auto instr = producer( 1);
+    rf.read_sources( &instr);
+    forwarding.issue( instr, 10);
+
+    // result is bypassed from MEM/WB latch after it has been computed
+    ASSERT_FALSE( forwarding.check_sources( consumer, 11));
+    forwarding.execute( instr, 11);
+    ASSERT_FALSE( forwarding.check_sources( consumer, 11));
+    ASSERT_TRUE( forwarding.check_sources( consumer, 12));
+}
+
+TEST( Forwarding, Loads)
+{
+    RF rf;
+    Forwarding execute_only( rf, "execute");
+    Forwarding full( rf, "execute,memory");
+    auto instr = load( 1);
+    rf.read_sources( &instr);
+    execute_only.issue( instr, 10);
+    full.issue( instr, 10);
+
+    // loaded value is available after memory access only
+    full.execute( instr, 11);
+    ASSERT_FALSE( full.check_sources( consumer, 20));
+
+    instr.set_v_dst( 7);
+    execute_only.complete( instr, 20);
+    full.complete( instr, 20);
+    ASSERT_FALSE( execute_only.check_sources( consumer, 20));
+    ASSERT_TRUE( full.check_sources( consumer, 20));
+}
+
+TEST( Forwarding, No_Paths)
+{
+    RF rf;
+    Forwarding forwarding( rf, "none");
+    auto instr = producer( 1);
+    rf.read_sources( &instr);
+    forwarding.issue( instr, 10);
+    forwarding.execute( instr, 11);
+    ASSERT_FALSE( forwarding.check_sources( consumer, 100));
+
+    // source is read from register file after writeback
+    rf.write_dst( instr);
+    ASSERT_TRUE( forwarding.check_sources( consumer, 100));
+}
+
+TEST( Forwarding, Younger_Result_Wins)
+{
+    RF rf;
+    Forwarding forwarding( rf, "execute,memory");
+    auto older = load( 1);
+    auto younger = producer( 2);
+    rf.read_sources( &older);
+    rf.read_sources( &younger);
+    forwarding.issue( older, 10);
+    forwarding.issue( younger, 11);
+
+    // older load comes from memory after the younger result is published
+    forwarding.execute( younger, 12);
+    older.set_v_dst( 7);
+    forwarding.complete( older, 20);
+
+    auto reader = consumer;
+    forwarding.read_sources( &reader);
+    reader.execute();
+    ASSERT_EQ( reader.get_v_dst(), 10u);
+}
+
+TEST( Forwarding, Cancel)
+{
+    RF rf;
+    Forwarding forwarding( rf, "execute,memory");
+    auto instr = producer( 1);
+    rf.read_sources( &instr);
+    forwarding.issue( instr, 10);
+    forwarding.execute( instr, 11);
+    forwarding.cancel( instr);
+
+    // flushed producer is neither waited nor bypassed
+    ASSERT_FALSE( forwarding.check_sources( consumer, 12));
+    auto reader = consumer;
+    forwarding.read_sources( &reader);
+    reader.execute();
+    ASSERT_EQ( reader.get_v_dst(), 0u);
+}
+
+/* jal 0x400100 at 0x400000 and jr $ra at 0x400100 */
+static const Addr CALL_PC = 0x400000;
+static const uint32 CALL = 0x0c100040;
+static const Addr RETURN_PC = 0x400100;
+static const uint32 RETURN = 0x03e00008;
+
+TEST( FrontEndPredictor, Call_Fetched_Again)
+{
+    FrontEndPredictor predictor( "dynamic_two_bit", BPParameters(), 16);
+
+    // fetch group with the call is thrown away by decode and fetched again
+    predictor.checkpoint();
+    predictor.predict( CALL_PC, CALL);
+    predictor.restore();
+    predictor.checkpoint();
+    predictor.predict( CALL_PC, CALL);
+
+    // the call is pushed once
+    ASSERT_EQ( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+    ASSERT_NE( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+}
+
+TEST( FrontEndPredictor, Return_Fetched_Again)
+{
+    FrontEndPredictor predictor( "dynamic_two_bit", BPParameters(), 16);
+    predictor.predict( CALL_PC, CALL);
+    predictor.predict( CALL_PC, CALL);
+
+    // the return is popped once
+    predictor.checkpoint();
+    ASSERT_EQ( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+    predictor.restore();
+    predictor.checkpoint();
+    ASSERT_EQ( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+    ASSERT_EQ( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+    ASSERT_NE( predictor.predict( RETURN_PC, RETURN).target, CALL_PC + 4);
+}
+
 int main( int argc, char* argv[])
 {
     ::testing::InitGoogleTest( &argc, argv);
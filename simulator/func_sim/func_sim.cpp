@@ -1,11 +1,13 @@
 #include <iostream>
 
+#include <infra/trace/address_trace.h>
+#include <infra/trace/branch_trace.h>
 #include <mips/mips_memory.h>
 #include <mips/mips_rf.h>
 
 #include "func_sim.h"
 
-MIPS::MIPS( bool log) : Log( log), rf( new RF) { }
+MIPS::MIPS( bool log) : Log( log), rf( new RF), address_trace( nullptr), branch_trace( nullptr) { }
 
 MIPS::~MIPS()
 {
@@ -29,6 +31,12 @@ std::string MIPS::step()
     // load/store
     mem->load_store( &instr);
 
+    if ( address_trace != nullptr)
+        trace_addresses( instr);
+
+    if ( branch_trace != nullptr)
+        trace_branch( instr);
+
     // writeback
     rf->write_dst( instr);
 
@@ -42,6 +50,32 @@ std::string MIPS::step()
     return instr.Dump();
 }
 
+void MIPS::trace_addresses( const FuncInstr& instr)
+{
+    address_trace->write( instr.get_PC(), AccessType::FETCH);
+    if ( instr.is_load())
+        address_trace->write( instr.get_mem_addr(), AccessType::LOAD);
+    else if ( instr.is_store())
+        address_trace->write( instr.get_mem_addr(), AccessType::STORE);
+}
+
+void MIPS::trace_branch( const FuncInstr& instr)
+{
+    branch_trace->add_instruction();
+    if ( instr.isJump())
+        branch_trace->write( instr.get_PC(), instr.get_raw(), instr.is_jump_taken(), instr.get_new_PC());
+}
+
+void MIPS::set_address_trace( const std::string& filename)
+{
+    address_trace = std::make_unique<AddressTraceWriter>( filename, 4, true);
+}
+
+void MIPS::set_branch_trace( const std::string& filename)
+{
+    branch_trace = std::make_unique<BranchTraceWriter>( filename);
+}
+
 void MIPS::init( const std::string& tr)
 {
     assert( mem == nullptr);
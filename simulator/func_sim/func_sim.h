@@ -13,6 +13,9 @@
 #include <infra/types.h>
 #include <infra/log.h>
 
+class AddressTraceWriter;
+class BranchTraceWriter;
+class FuncInstr;
 class MIPSMemory;
 class RF;
 
@@ -22,6 +25,11 @@ class MIPS : public Log
         std::unique_ptr<RF> rf;
         Addr PC = NO_VAL32;
         MIPSMemory* mem = nullptr;
+        std::unique_ptr<AddressTraceWriter> address_trace;
+        std::unique_ptr<BranchTraceWriter> branch_trace;
+
+        void trace_addresses( const FuncInstr& instr);
+        void trace_branch( const FuncInstr& instr);
     public:
         explicit MIPS( bool log = false);
         ~MIPS() final;
@@ -30,6 +38,10 @@ class MIPS : public Log
         MIPS& operator=( const MIPS&) = delete;
 
         void init( const std::string& tr);
+        /* writes addresses of fetches, loads and stores to the binary trace */
+        void set_address_trace( const std::string& filename);
+        /* writes outcomes and targets of branches to the binary trace */
+        void set_branch_trace( const std::string& filename);
         std::string step();
         void run(const std::string& tr, uint32 instrs_to_run);
 };
@@ -1,11 +1,17 @@
 // generic C
 #include <cassert>
+#include <cstdio>
 #include <cstdlib>
 
 // Google Test library
 #include <gtest/gtest.h>
 
 // Module
+#include <infra/memory/memory.h>
+#include <infra/trace/address_trace.h>
+#include <infra/trace/branch_trace.h>
+#include <mips/mips_instr.h>
+
 #include "../func_sim.h"
 
 static const std::string valid_elf_file = TEST_PATH;
@@ -40,6 +46,70 @@ TEST( Func_Sim, Run_Full_Trace)
     GTEST_ASSERT_NO_DEATH( mips.run( valid_elf_file, num_steps); );
 }
 
+TEST( Func_Sim, Address_Trace)
+{
+    const std::string trace_file = "./test.trace";
+    {
+        MIPS mips;
+        mips.init( valid_elf_file);
+        mips.set_address_trace( trace_file);
+        for ( int64 i = 0; i < num_steps; ++i)
+            mips.step();
+    }
+
+    const AddressTrace trace( trace_file);
+    ASSERT_EQ( trace.get_addr( 0), Memory( valid_elf_file).startPC());
+    ASSERT_EQ( trace.get_type( 0), AccessType::FETCH);
+
+    // each instruction is fetched, some of them access data
+    uint64 fetches = 0;
+    for ( size_t i = 0; i < trace.size(); ++i)
+        if ( trace.get_type( i) == AccessType::FETCH)
+            ++fetches;
+
+    ASSERT_EQ( fetches, num_steps);
+    ASSERT_GT( trace.size(), fetches);
+
+    // data cache simulation selects loads and stores only
+    const auto data_types = AccessTypes::parse( "load,store");
+    uint64 data_accesses = 0;
+    for ( size_t i = 0; i < trace.size(); ++i)
+        if ( data_types.contains( trace.get_type( i)))
+            ++data_accesses;
+
+    ASSERT_GT( data_accesses, 0u);
+    ASSERT_EQ( data_accesses + fetches, trace.size());
+    std::remove( trace_file.c_str());
+}
+
+TEST( Func_Sim, Branch_Trace)
+{
+    const std::string trace_file = "./test.trace";
+    {
+        MIPS mips;
+        mips.init( valid_elf_file);
+        mips.set_branch_trace( trace_file);
+        for ( int64 i = 0; i < num_steps; ++i)
+            mips.step();
+    }
+
+    const BranchTrace trace( trace_file);
+    ASSERT_GT( trace.size(), 0u);
+
+    // each instruction is counted once, ones after the last branch are not written
+    uint64 instructions = 0;
+    for ( size_t i = 0; i < trace.size(); ++i)
+    {
+        instructions += trace.get_instructions( i);
+        ASSERT_TRUE( trace.is_taken( i) || trace.get_target( i) == trace.get_PC( i) + 4);
+        ASSERT_TRUE( !FuncInstr::is_call( trace.get_raw( i)) || trace.is_taken( i));
+    }
+
+    ASSERT_LE( instructions, num_steps);
+    ASSERT_GT( instructions, trace.size());
+    std::remove( trace_file.c_str());
+}
+
 int main( int argc, char* argv[])
 {
     ::testing::InitGoogleTest( &argc, argv);
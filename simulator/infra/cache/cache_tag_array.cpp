@@ -11,44 +11,17 @@
 /* C++ generic modules */
 #include <iostream>
 
+/* SIMD intrinsics */
+#if defined(__SSE2__) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
 /* MIPT-MIPS infra */
 #include <infra/macro.h>
 
 /* MIPT-MIPS modules */
 #include "cache_tag_array.h"
 
-LRUInfo::LRUInfo( uint32 ways, uint32 sets) : lru( sets)
-{
-    std::list< uint32> l;
-    for ( uint32 i = 0; i < ways; ++i)
-    {
-        l.push_front( i);
-    }
-    std::fill_n( lru.begin(), sets, l);
-}
-
-/* On hit - mark (push front) way that contains the set */
-void LRUInfo::touch( uint32 set, uint32 way)
-{
-    auto& list = lru[ set];
-    for ( auto it = list.begin(); it != list.end(); ++it)
-    {
-        if ( *it == way)
-        {
-            list.splice( list.begin(), list, it);
-            return;
-        }
-    }
-}
-
-/* Get number of the Least Resently Used way and push front it */
-uint32 LRUInfo::update( uint32 set)
-{
-    auto& list = lru[ set];
-    list.splice( list.begin(), list, std::prev( list.end()));
-    return list.front();
-}
-
 CacheTagArrayCheck::CacheTagArrayCheck(
     uint32 size_in_bytes,
     uint32 ways,
@@ -106,27 +79,52 @@ CacheTagArrayCheck::CacheTagArrayCheck(
                   << "2." << critical;
 }
 
+/* Returns position of the first of "count" lines equal to "line", or "count" if there is no such */
+static uint32 find_line( const Addr* lines, uint32 count, Addr line)
+{
+    static_assert( sizeof( Addr) == sizeof( int32), "lines are compared as 32-bit integers");
+
+    uint32 i = 0;
+#if defined(__AVX2__)
+    const __m256i key8 = _mm256_set1_epi32( static_cast<int32>( line));
+    for ( ; i + 8 <= count; i += 8)
+    {
+        const __m256i values = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( lines + i));
+        const auto mask = _mm256_movemask_ps( _mm256_castsi256_ps( _mm256_cmpeq_epi32( values, key8)));
+        if ( mask != 0)
+            return i + count_trailing_zeros( static_cast<uint32>( mask));
+    }
+#endif
+#if defined(__SSE2__) || defined(_M_X64)
+    const __m128i key4 = _mm_set1_epi32( static_cast<int32>( line));
+    for ( ; i + 4 <= count; i += 4)
+    {
+        const __m128i values = _mm_loadu_si128( reinterpret_cast<const __m128i*>( lines + i));
+        const auto mask = _mm_movemask_ps( _mm_castsi128_ps( _mm_cmpeq_epi32( values, key4)));
+        if ( mask != 0)
+            return i + count_trailing_zeros( static_cast<uint32>( mask));
+    }
+#endif
+    for ( ; i < count; ++i)
+        if ( lines[ i] == line)
+            return i;
+
+    return count;
+}
+
 CacheTagArray::CacheTagArray( uint32 size_in_bytes,
                               uint32 ways,
                               uint32 line_size,
-                              uint32 addr_size_in_bits) :
+                              uint32 addr_size_in_bits,
+                              const std::string& replacement_policy) :
                               CacheTagArrayCheck( size_in_bytes, ways,
                                                   line_size, addr_size_in_bits),
                               num_sets( size_in_bytes / ( line_size * ways))
 {
-    /* Allocate memory for cache sets and LRU module. */
-    array.resize( num_sets);
-    for ( auto& entry : array)
-    {
-        entry.resize( ways);
-    }
-    lru = new LRUInfo( ways, num_sets);
-}
-
-CacheTagArray::~CacheTagArray()
-{
-    /* Free memory used by LRU module. */
-    delete lru;
+    /* Allocate memory for cache sets and replacement module. */
+    lines.resize( static_cast<size_t>( num_sets) * ways);
+    filled_ways.resize( num_sets, 0);
+    replacement = ReplacementPolicyFactory().create( replacement_policy, ways, num_sets);
 }
 
 std::pair<bool, uint32> CacheTagArray::read( Addr addr)
@@ -137,7 +135,7 @@ std::pair<bool, uint32> CacheTagArray::read( Addr addr)
     {
         const auto set_num = set( addr);
         const auto way_num = lookup_result.second;
-        lru->touch( set_num, way_num); // update LRU info
+        replacement->touch( set_num, way_num); // update replacement info
     }
 
     return lookup_result;
@@ -146,26 +144,27 @@ std::pair<bool, uint32> CacheTagArray::read( Addr addr)
 std::pair<bool, uint32> CacheTagArray::read_no_touch( Addr addr) const
 {
     const auto set_num = set( addr);
-    const auto tag_num = tag( addr);
+    const auto valid_ways = filled_ways[ set_num];
 
-    /* search into each way */
-    for ( uint32 i = 0; i < ways; ++i)
-    {
-        const auto& entry = array[ set_num][ i];
+    /* search into each valid way */
+    const auto way_num = find_line( &lines[ static_cast<size_t>( set_num) * ways], valid_ways, tag( addr));
+    if ( way_num != valid_ways) // hit
+        return std::make_pair(true, way_num);
 
-        if ( entry.is_valid && entry.line == tag_num) // hit
-            return std::make_pair(true, i);
-    }
     return std::make_pair(false, NO_VAL32); // miss (no data)
 }
 
 uint32 CacheTagArray::write( Addr addr)
 {
     uint32 set_num = set( addr);
-    uint32 way_num = lru->update( set_num); // get l.r.u. way
 
-    array[ set_num][ way_num].line = tag( addr); // write it
-    array[ set_num][ way_num].is_valid = true; // this set is valid now
+    /* lines are not invalidated, so ways are filled in order before the policy chooses victims */
+    uint32 way_num = filled_ways[ set_num] < ways
+                     ? filled_ways[ set_num]++
+                     : replacement->get_victim( set_num);
+
+    lines[ static_cast<size_t>( set_num) * ways + way_num] = tag( addr); // write it
+    replacement->insert( set_num, way_num);
 
     return way_num;
 }
@@ -10,27 +10,15 @@
 #define CACHE_TAG_ARRAY_H
 
 /* C++ libraries. */
-#include <list>
+#include <memory>
+#include <string>
 #include <vector>
 
 /* Simulator modules. */
 #include <infra/types.h>
 #include <infra/log.h>
 
-/* Replacement algorithm modules (LRU). */
-class LRUInfo
-{
-    /*
-     * "lru" contains sequences of using for each set. First number in set list
-     * is the least used.
-     */
-    std::vector< std::list< uint32>> lru = {};
-
-public:
-    LRUInfo( uint32 ways, uint32 sets);
-    void touch( uint32 set, uint32 way);
-    uint32 update( uint32 set);
-};
+#include "replacement.h"
 
 class CacheTagArrayCheck : private Log
 {
@@ -50,15 +38,14 @@ public:
 class CacheTagArray : public CacheTagArrayCheck
 {
     private:
-        /* The set (line) of the cache. */
-        struct CacheTag
-        {
-            Addr line = 0; // data
-            bool is_valid = false; // validity
-        };
-
-        std::vector<std::vector<CacheTag>> array = {}; // array of tags
-        LRUInfo* lru = nullptr; // LRU algorithm module
+        /*
+         * Lines of the set are stored contiguously, so all the ways are compared at once.
+         * Lines are not invalidated and ways are filled in order,
+         * so the first "filled_ways" of the set are valid.
+         */
+        std::vector<Addr> lines = {}; // "ways" lines per set
+        std::vector<uint32> filled_ways = {}; // number of valid ways in each set
+        std::unique_ptr<ReplacementPolicy> replacement = nullptr;
 
         const uint32 num_sets;
 
@@ -66,15 +53,16 @@ class CacheTagArray : public CacheTagArrayCheck
         CacheTagArray( uint32 size_in_bytes,
                        uint32 ways,
                        uint32 line_size = 4,
-                       uint32 addr_size_in_bits = 32);
-        ~CacheTagArray() override;
+                       uint32 addr_size_in_bits = 32,
+                       const std::string& replacement_policy = "lru");
+        ~CacheTagArray() override = default;
 
         CacheTagArray& operator=( const CacheTagArray&) = delete;
         CacheTagArray( const CacheTagArray&) = delete;
 
-        /* lookup the cache and update LRU info */
+        /* lookup the cache and update replacement info */
         std::pair<bool, uint32> read( Addr addr);
-        /* find in the cache but do not update LRU info */
+        /* find in the cache but do not update replacement info */
         std::pair<bool, uint32> read_no_touch( Addr addr) const;
         /* create new entry in cache */
         uint32 write( Addr addr);
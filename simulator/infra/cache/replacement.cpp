@@ -0,0 +1,204 @@
+/*
+ * replacement.cpp - replacement policies of cache tag array
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C++ generic modules */
+#include <algorithm>
+
+/* MIPT-MIPS infra */
+#include <infra/macro.h>
+
+/* MIPT-MIPS modules */
+#include "replacement.h"
+
+static const uint8 RRPV_MAX = 3;
+static const uint32 BRRIP_LONG_INSERTION_PERIOD = 32;
+
+LRUInfo::LRUInfo( uint32 ways, uint32 sets)
+    : ways( ways)
+    , nodes( ways * sets)
+    , mru( sets, ways - 1)
+    , lru( sets, 0)
+{
+    /* initially way 0 is the least recently used one */
+    for ( uint32 set = 0; set < sets; ++set)
+    {
+        Node* list = &nodes[ set * ways];
+        for ( uint32 i = 0; i < ways; ++i)
+        {
+            list[ i].prev = i + 1;
+            list[ i].next = i - 1;
+        }
+    }
+}
+
+/* On hit - mark (move to head) way that contains the set */
+void LRUInfo::touch( uint32 set, uint32 way)
+{
+    const uint32 head = mru[ set];
+    if ( head == way)
+        return;
+
+    Node* list = &nodes[ set * ways];
+    auto& node = list[ way];
+
+    /* unlink */
+    list[ node.prev].next = node.next;
+    if ( way == lru[ set])
+        lru[ set] = node.prev;
+    else
+        list[ node.next].prev = node.prev;
+
+    /* link before the head */
+    node.next = head;
+    list[ head].prev = way;
+    mru[ set] = way;
+}
+
+/* Get number of the Least Resently Used way */
+uint32 LRUInfo::get_victim( uint32 set)
+{
+    return lru[ set];
+}
+
+/* New line is written to the way, it becomes the most recently used one */
+void LRUInfo::insert( uint32 set, uint32 way)
+{
+    touch( set, way);
+}
+
+TreePLRU::TreePLRU( uint32 ways, uint32 sets)
+    : ways( ways)
+    , trees( sets, std::vector<bool>( ways - 1, false))
+{ }
+
+/* Nodes on the path to the way point to the other halves */
+void TreePLRU::touch( uint32 set, uint32 way)
+{
+    auto& tree = trees[ set];
+    uint32 node = 0;
+    for ( uint32 begin = 0, size = ways; size > 1; size /= 2)
+    {
+        const bool is_right = way >= begin + size / 2;
+        tree[ node] = !is_right;
+        node = 2 * node + ( is_right ? 2 : 1);
+        if ( is_right)
+            begin += size / 2;
+    }
+}
+
+uint32 TreePLRU::get_victim( uint32 set)
+{
+    const auto& tree = trees[ set];
+    uint32 node = 0;
+    uint32 begin = 0;
+    for ( uint32 size = ways; size > 1; size /= 2)
+    {
+        const bool is_right = tree[ node];
+        node = 2 * node + ( is_right ? 2 : 1);
+        if ( is_right)
+            begin += size / 2;
+    }
+
+    return begin;
+}
+
+NRU::NRU( uint32 ways, uint32 sets)
+    : used( sets, std::vector<bool>( ways, false))
+{ }
+
+void NRU::touch( uint32 set, uint32 way)
+{
+    auto& bits = used[ set];
+    bits[ way] = true;
+    if ( std::find( bits.begin(), bits.end(), false) != bits.end())
+        return;
+
+    std::fill( bits.begin(), bits.end(), false);
+    bits[ way] = true;
+}
+
+uint32 NRU::get_victim( uint32 set)
+{
+    const auto& bits = used[ set];
+    return static_cast<uint32>( std::find( bits.begin(), bits.end(), false) - bits.begin());
+}
+
+RRIP::RRIP( uint32 ways, uint32 sets, bool is_bimodal)
+    : is_bimodal( is_bimodal)
+    , rrpv( sets, std::vector<uint8>( ways, RRPV_MAX))
+{ }
+
+void RRIP::touch( uint32 set, uint32 way)
+{
+    rrpv[ set][ way] = 0;
+}
+
+/* Lines are aged till one of them is predicted to be re-referenced in distant future */
+uint32 RRIP::get_victim( uint32 set)
+{
+    auto& values = rrpv[ set];
+    while ( true)
+    {
+        const auto it = std::find( values.begin(), values.end(), RRPV_MAX);
+        if ( it != values.end())
+            return static_cast<uint32>( it - values.begin());
+
+        for ( auto& value : values)
+            ++value;
+    }
+}
+
+void RRIP::insert( uint32 set, uint32 way)
+{
+    const bool is_long = !is_bimodal || ++insertions % BRRIP_LONG_INSERTION_PERIOD == 0;
+    rrpv[ set][ way] = is_long ? RRPV_MAX - 1 : RRPV_MAX;
+}
+
+RandomReplacement::RandomReplacement( uint32 ways)
+    : ways( ways)
+    , generator()
+{ }
+
+uint32 RandomReplacement::get_victim( uint32 /* set */)
+{
+    return static_cast<uint32>( generator() % ways);
+}
+
+std::unique_ptr<ReplacementPolicy> ReplacementPolicyFactory::create( const std::string& name,
+                                                                    uint32 ways,
+                                                                    uint32 sets) const
+{
+    if ( name == "lru")
+        return std::make_unique<LRUInfo>( ways, sets);
+
+    if ( name == "plru")
+    {
+        if ( !is_power_of_two( ways))
+            serr << "ERROR: Wrong arguments! Tree pseudo-LRU requires number of ways to be a power of 2"
+                 << std::endl << critical;
+
+        return std::make_unique<TreePLRU>( ways, sets);
+    }
+
+    if ( name == "nru")
+        return std::make_unique<NRU>( ways, sets);
+
+    if ( name == "srrip")
+        return std::make_unique<RRIP>( ways, sets, false);
+
+    if ( name == "brrip")
+        return std::make_unique<RRIP>( ways, sets, true);
+
+    if ( name == "random")
+        return std::make_unique<RandomReplacement>( ways);
+
+    serr << "ERROR: Invalid replacement policy " << name << std::endl
+         << "Supported policies:" << std::endl;
+    for ( const auto& policy : { "lru", "plru", "nru", "srrip", "brrip", "random"})
+        serr << "\t" << policy << std::endl;
+
+    serr << critical;
+    return nullptr;
+}
@@ -0,0 +1,136 @@
+/*
+ * replacement.h - replacement policies of cache tag array
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef REPLACEMENT_H
+#define REPLACEMENT_H
+
+/* C++ libraries. */
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+/* Simulator modules. */
+#include <infra/log.h>
+#include <infra/types.h>
+
+/*
+ * Policy keeps replacement state of each set. Tag array fills
+ * invalid ways first, so the policy chooses victims among valid ones.
+ */
+class ReplacementPolicy
+{
+public:
+    /* hit to the way */
+    virtual void touch( uint32 set, uint32 way) = 0;
+    /* way to be replaced in the set */
+    virtual uint32 get_victim( uint32 set) = 0;
+    /* new line is written to the way */
+    virtual void insert( uint32 set, uint32 way) = 0;
+
+    virtual ~ReplacementPolicy() = default;
+};
+
+/*
+ * True least recently used. Ways of each set are linked into the list
+ * by their numbers, from the most recently used to the least recently used one.
+ * Links are kept in flat arrays, so hit moves the way to the head
+ * in constant time without allocations.
+ */
+class LRUInfo : public ReplacementPolicy
+{
+    struct Node
+    {
+        uint32 prev; // more recently used way
+        uint32 next; // less recently used way
+    };
+
+    const uint32 ways;
+    std::vector<Node> nodes; // "ways" nodes per set
+    std::vector<uint32> mru;
+    std::vector<uint32> lru;
+
+public:
+    LRUInfo( uint32 ways, uint32 sets);
+    void touch( uint32 set, uint32 way) final;
+    uint32 get_victim( uint32 set) final;
+    void insert( uint32 set, uint32 way) final;
+};
+
+/*
+ * Tree pseudo-LRU: each node of binary tree over ways points
+ * to the half which was used less recently.
+ */
+class TreePLRU : public ReplacementPolicy
+{
+    const uint32 ways;
+    std::vector<std::vector<bool>> trees; // "ways - 1" nodes per set
+
+public:
+    TreePLRU( uint32 ways, uint32 sets);
+    void touch( uint32 set, uint32 way) final;
+    uint32 get_victim( uint32 set) final;
+    void insert( uint32 set, uint32 way) final { touch( set, way); }
+};
+
+/*
+ * Not recently used: one bit per way. When all the ways of the set
+ * are used, bits of the others are cleared.
+ */
+class NRU : public ReplacementPolicy
+{
+    std::vector<std::vector<bool>> used;
+
+public:
+    NRU( uint32 ways, uint32 sets);
+    void touch( uint32 set, uint32 way) final;
+    uint32 get_victim( uint32 set) final;
+    void insert( uint32 set, uint32 way) final { touch( set, way); }
+};
+
+/*
+ * Re-reference interval prediction with 2-bit counters.
+ * Static RRIP inserts lines with long re-reference interval,
+ * bimodal RRIP inserts them with distant one, except every 32nd line,
+ * so the lines used once do not thrash the cache.
+ */
+class RRIP : public ReplacementPolicy
+{
+    const bool is_bimodal;
+    std::vector<std::vector<uint8>> rrpv;
+    uint32 insertions = 0;
+
+public:
+    RRIP( uint32 ways, uint32 sets, bool is_bimodal);
+    void touch( uint32 set, uint32 way) final;
+    uint32 get_victim( uint32 set) final;
+    void insert( uint32 set, uint32 way) final;
+};
+
+/* random victim, generator is seeded by constant to have reproducible results */
+class RandomReplacement : public ReplacementPolicy
+{
+    const uint32 ways;
+    std::minstd_rand generator;
+
+public:
+    explicit RandomReplacement( uint32 ways);
+    void touch( uint32 /* set */, uint32 /* way */) final { }
+    uint32 get_victim( uint32 set) final;
+    void insert( uint32 /* set */, uint32 /* way */) final { }
+};
+
+/* creates policy by name: lru, plru, nru, srrip, brrip or random */
+class ReplacementPolicyFactory : private Log
+{
+public:
+    ReplacementPolicyFactory() : Log( false) { }
+
+    std::unique_ptr<ReplacementPolicy> create( const std::string& name,
+                                               uint32 ways,
+                                               uint32 sets) const;
+};
+
+#endif // REPLACEMENT_H
@@ -0,0 +1,126 @@
+/*
+ * stack_distance.cpp - single-pass miss rate profiling of LRU caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C++ generic modules */
+#include <algorithm>
+#include <numeric>
+
+/* MIPT-MIPS infra */
+#include <infra/macro.h>
+
+/* MIPT-MIPS modules */
+#include "stack_distance.h"
+
+StackDistanceProfiler::StackDistanceProfiler( uint32 line_size, uint32 num_sets, uint32 max_ways)
+    : Log( false)
+    , line_size( line_size)
+    , num_sets( num_sets)
+    , max_ways( max_ways)
+    , stacks( static_cast<size_t>( num_sets) * max_ways)
+    , depths( num_sets, 0)
+    , histogram( max_ways + 1, 0)
+{
+    if ( line_size == 0 || !is_power_of_two( line_size))
+        serr << "ERROR: Wrong arguments! Block size should be a power of 2." << critical;
+
+    if ( num_sets == 0 || !is_power_of_two( num_sets))
+        serr << "ERROR: Wrong arguments! Number of sets should be a power of 2." << critical;
+
+    if ( max_ways == 0)
+        serr << "ERROR: Wrong arguments! Num of ways should be greater than zero" << critical;
+}
+
+void StackDistanceProfiler::access( uint64 addr)
+{
+    ++accesses;
+
+    const uint64 line = addr / line_size;
+    const auto set = static_cast<uint32>( line & ( num_sets - 1));
+    uint64* stack = &stacks[ static_cast<size_t>( set) * max_ways];
+    uint32& depth = depths[ set];
+
+    /* lines which are not in the stack miss in all the caches */
+    const auto distance = static_cast<uint32>( std::find( stack, stack + depth, line) - stack);
+    const bool is_found = distance < depth;
+    ++histogram[ is_found ? distance : max_ways];
+
+    if ( !is_found && depth < max_ways)
+        ++depth;
+
+    /* move the line to the top */
+    std::copy_backward( stack, stack + std::min( distance, max_ways - 1), stack + std::min( distance + 1, max_ways));
+    stack[ 0] = line;
+}
+
+uint64 StackDistanceProfiler::get_misses( uint32 ways) const
+{
+    return std::accumulate( histogram.begin() + std::min( ways, max_ways), histogram.end(), uint64{ 0});
+}
+
+ReuseDistanceProfiler::ReuseDistanceProfiler( uint32 line_size)
+    : Log( false)
+    , line_size( line_size)
+    , tree( 2, 0)
+{
+    if ( line_size == 0 || !is_power_of_two( line_size))
+        serr << "ERROR: Wrong arguments! Block size should be a power of 2." << critical;
+}
+
+/* Fenwick tree is indexed from 1 */
+void ReuseDistanceProfiler::add( uint64 time, int32 value)
+{
+    for ( auto i = time + 1; i < tree.size(); i += i & ( ~i + 1))
+        tree[ i] += value;
+}
+
+uint32 ReuseDistanceProfiler::count_before( uint64 time) const
+{
+    uint32 result = 0;
+    for ( auto i = time; i > 0; i -= i & ( ~i + 1))
+        result += tree[ i];
+
+    return result;
+}
+
+void ReuseDistanceProfiler::access( uint64 addr)
+{
+    const uint64 time = accesses++;
+
+    /*
+     * Doubled tree keeps the old nodes, the new ones cover
+     * only the new empty range, except the root which sums all.
+     */
+    const auto capacity = tree.size() - 1;
+    if ( time == capacity)
+    {
+        const auto total = count_before( capacity);
+        tree.resize( 2 * capacity + 1, 0);
+        tree.back() = total;
+    }
+
+    const auto it = last_access.find( addr / line_size);
+    if ( it == last_access.end())
+    {
+        last_access.emplace( addr / line_size, time);
+    }
+    else
+    {
+        const uint32 distance = count_before( time) - count_before( it->second + 1);
+        if ( histogram.size() <= distance)
+            histogram.resize( distance + 1, 0);
+
+        ++histogram[ distance];
+        add( it->second, -1);
+        it->second = time;
+    }
+
+    add( time, 1);
+}
+
+uint64 ReuseDistanceProfiler::get_misses( uint32 ways) const
+{
+    const auto end = histogram.begin() + std::min<size_t>( ways, histogram.size());
+    return accesses - std::accumulate( histogram.begin(), end, uint64{ 0});
+}
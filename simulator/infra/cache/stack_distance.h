@@ -0,0 +1,73 @@
+/*
+ * stack_distance.h - single-pass miss rate profiling of LRU caches
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef STACK_DISTANCE_H
+#define STACK_DISTANCE_H
+
+/* C++ libraries. */
+#include <unordered_map>
+#include <vector>
+
+/* Simulator modules. */
+#include <infra/types.h>
+#include <infra/log.h>
+
+/*
+ * LRU caches have inclusion property: the access hits in the cache with W ways
+ * if less than W other lines of the same set were used since the previous
+ * access to the line (Mattson's stack distance). So one pass over the trace
+ * gives miss rates of all the caches with the same number of sets.
+ */
+class StackDistanceProfiler : private Log
+{
+    const uint32 line_size;
+    const uint32 num_sets;
+    const uint32 max_ways;
+
+    std::vector<uint64> stacks; // "max_ways" lines per set, the most recently used first
+    std::vector<uint32> depths; // number of lines in each stack
+    std::vector<uint64> histogram; // "max_ways" entry counts misses of all the caches
+
+    uint64 accesses = 0;
+
+public:
+    StackDistanceProfiler( uint32 line_size, uint32 num_sets, uint32 max_ways);
+
+    void access( uint64 addr);
+
+    uint64 get_accesses() const { return accesses; }
+    /* misses of the cache with "ways" ways, which should not exceed "max_ways" */
+    uint64 get_misses( uint32 ways) const;
+};
+
+/*
+ * Fully associative caches have too many ways to keep the stacks,
+ * so the distance is the number of lines, whose last access lies between
+ * two accesses to the line. Last accesses are marked in Fenwick tree over time.
+ */
+class ReuseDistanceProfiler : private Log
+{
+    const uint32 line_size;
+
+    std::unordered_map<uint64, uint64> last_access = {}; // time of the last access to each line
+    std::vector<uint32> tree; // Fenwick tree, its capacity is a power of 2
+    std::vector<uint64> histogram = {};
+
+    uint64 accesses = 0;
+
+    void add( uint64 time, int32 value);
+    uint32 count_before( uint64 time) const;
+
+public:
+    explicit ReuseDistanceProfiler( uint32 line_size);
+
+    void access( uint64 addr);
+
+    uint64 get_accesses() const { return accesses; }
+    /* misses of fully associative cache of "ways" lines */
+    uint64 get_misses( uint32 ways) const;
+};
+
+#endif // STACK_DISTANCE_H
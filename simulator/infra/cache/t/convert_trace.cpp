@@ -0,0 +1,49 @@
+/**
+ * convert_trace.cpp
+ * Converts text file with hexadecimal memory access addresses
+ * to binary address trace read by miss_rate_sim.
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C libraries. */
+#include <cstdlib>
+
+/* C++ libraries. */
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+/* Simulator modules. */
+#include <infra/trace/address_trace.h>
+
+int main( int argc, char* argv[])
+{
+    if ( argc != 3)
+    {
+        std::cerr << "ERROR: Wrong number of arguments! Required 2: name of text file "
+                  << "with memory access addresses; name of output binary trace." << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    std::ifstream file_in( argv[ 1]);
+    if ( !file_in.is_open())
+    {
+        std::cerr << "ERROR: Can't open the input file!" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    std::vector<uint64> addrs;
+    uint64 addr;
+    while ( file_in >> std::hex >> addr)
+        addrs.push_back( addr);
+
+    /* text traces carry no access types, addresses are 32-bit unless they do not fit */
+    const bool is_wide = std::any_of( addrs.begin(), addrs.end(), []( uint64 value) { return value > UINT32_MAX; });
+    AddressTraceWriter trace( argv[ 2], is_wide ? 8 : 4, false);
+    for ( const auto value : addrs)
+        trace.write( value);
+
+    std::cout << addrs.size() << " addresses are written" << std::endl;
+    return 0;
+}
@@ -6,112 +6,268 @@
  */
 
 /* C libraries. */
+#include <cstdint>
 #include <cstdlib>
 
 /* C++ libraries. */
+#include <algorithm>
 #include <iostream>
 #include <fstream>
+#include <list>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 /* Simulator modules. */
-#include "../cache_tag_array.h"
+#include <infra/thread_pool.h>
+#include <infra/trace/address_trace.h>
+
+#include "../stack_distance.h"
 
 using namespace std;
 
-int main( int argc, char* argv[])
+static const uint32 FULLY_ASSOCIATIVE = 0;
+
+/* Addresses of the input file shared by all the threads. */
+class Trace
 {
-    /* Check arguments. */
-    if ( argc != 3)
+    unique_ptr<AddressTrace> binary = nullptr;
+    vector<uint64> text = {};
+    const AccessTypes types;
+    size_t num_accesses = 0;
+
+public:
+    Trace( const string& filename, const AccessTypes& types) : types( types)
     {
-        cerr << "ERROR: Wrong number of arguments! Required 2: name of file "
-             << "with memory access addresses; name of output file with miss "
-             << "rates." << endl;
-        exit( EXIT_FAILURE);
+        /* Input is either binary address trace or text file with hexadecimal addresses. */
+        if ( AddressTrace::is_address_trace( filename))
+        {
+            binary = make_unique<AddressTrace>( filename);
+            for ( size_t i = 0; i < binary->size(); ++i)
+                if ( is_selected( i))
+                    ++num_accesses;
+            return;
+        }
+
+        ifstream file_in;
+        file_in.open( filename, ifstream::in);
+        if ( !file_in.is_open())
+        {
+            cerr << "ERROR: Can't open the input file!" << endl;
+            exit( EXIT_FAILURE);
+        }
+
+        uint64 addr; // storage for address
+        while ( file_in >> hex >> addr) // while file contains addresses
+            text.push_back( addr);
+
+        num_accesses = text.size();
     }
-    if ( argv[ 1] == nullptr)
+
+    size_t size() const { return binary != nullptr ? binary->size() : text.size(); }
+    /* number of the selected accesses */
+    size_t get_num_accesses() const { return num_accesses; }
+
+    /* traces without access types are not filtered */
+    bool is_selected( size_t index) const
     {
-        cerr << "ERROR: Wrong first argument! Required name of file with "
-             << "memory access addresses." << endl;
-        exit( EXIT_FAILURE);
+        return binary == nullptr || !binary->has_access_types() || types.contains( binary->get_type( index));
     }
-    if ( argv[ 2] == nullptr)
+
+    uint64 get_addr( size_t index) const { return binary != nullptr ? binary->get_addr( index) : text[ index]; }
+};
+
+struct Configuration
+{
+    uint32 line_size;
+    uint32 size_in_kbytes;
+    uint32 ways; // FULLY_ASSOCIATIVE for full-associative cache
+    uint64 misses;
+};
+
+/* Parses comma-separated list of numbers, "full" stands for full-associative cache. */
+static list<uint32> parse_list( const string& option, const string& value)
+{
+    list<uint32> result;
+    istringstream stream( value);
+    string item;
+    while ( getline( stream, item, ','))
+    {
+        if ( item == "full" && option == "--ways")
+        {
+            result.push_back( FULLY_ASSOCIATIVE);
+            continue;
+        }
+
+        char* end = nullptr;
+        const auto number = strtoul( item.c_str(), &end, 10);
+        if ( item.empty() || *end != '\0' || number == 0 || number > UINT32_MAX)
+        {
+            cerr << "ERROR: Wrong value " << item << " of " << option << " option!" << endl;
+            exit( EXIT_FAILURE);
+        }
+        result.push_back( static_cast<uint32>( number));
+    }
+
+    if ( result.empty())
     {
-        cerr << "ERROR: Wrong second argument! Required name of output file "
-             << "with miss rates." << endl;
+        cerr << "ERROR: Empty list of " << option << " option!" << endl;
         exit( EXIT_FAILURE);
     }
 
-    /* Open and check input and output files. */
-    ifstream file_in;
-    file_in.open( argv[ 1], ifstream::in);
-    if ( !file_in.is_open())
+    return result;
+}
+
+static bool is_power_of_two( uint64 value) { return value != 0 && ( value & ( value - 1)) == 0; }
+
+static uint32 get_num_sets( const Configuration& config)
+{
+    const uint64 size_in_bytes = 1024ull * config.size_in_kbytes;
+    const uint64 lines = size_in_bytes / config.line_size;
+    const uint32 ways = config.ways == FULLY_ASSOCIATIVE ? static_cast<uint32>( lines) : config.ways;
+
+    if ( !is_power_of_two( config.line_size) || lines % ways != 0 || !is_power_of_two( lines / ways))
     {
-        cerr << "ERROR: Can't open the input file!" << endl;
+        cerr << "ERROR: Wrong configuration! Cache of " << config.size_in_kbytes << " KB with "
+             << config.line_size << "-byte lines and " << config.ways << " ways should have "
+             << "number of sets which is a power of 2." << endl;
         exit( EXIT_FAILURE);
     }
-    ofstream file_out;
-    file_out.open( argv[ 2], ofstream::out);
-    if ( !file_out.is_open())
+
+    return static_cast<uint32>( lines / ways);
+}
+
+int main( int argc, char* argv[])
+{
+    /* Check arguments. */
+    if ( argc < 3 || argc % 2 == 0)
     {
-        cerr << "ERROR: Can't open the output file!" << endl;
+        cerr << "ERROR: Wrong number of arguments! Required 2: name of file "
+             << "with memory access addresses; name of output file with miss "
+             << "rates. Optional: --sizes <list of sizes in KB>, "
+             << "--ways <list of numbers of ways or \"full\">, "
+             << "--line-sizes <list of line sizes in bytes>, --threads <number>, "
+             << "--types <list of access types of binary trace: load, store, fetch; "
+             << "default is load,store>. "
+             << "Lists are comma-separated, each line size gives a table "
+             << "with a row for each number of ways, tables of several line sizes are titled." << endl;
         exit( EXIT_FAILURE);
     }
 
     /* Cache parametres. */
-    std::list<int> associativities = { 1, 2, 4, 8, 16 };
-    std::list<int> cache_sizes = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
-    uint32 addr; // storage for address
+    list<uint32> associativities = { 1, 2, 4, 8, 16, FULLY_ASSOCIATIVE };
+    list<uint32> cache_sizes = { 1, 2, 4, 8, 16, 32, 64, 128, 256, 512, 1024 };
+    list<uint32> line_sizes = { 4 };
+    uint32 num_threads = 0; // number of hardware threads
+    AccessTypes types = AccessTypes::parse( "load,store"); // instruction fetches go to another cache
 
-    for ( auto associativity : associativities)
+    for ( int i = 3; i < argc; i += 2)
     {
-        for ( auto cache_size : cache_sizes) // by cache size
+        const string option = argv[ i];
+        if ( option == "--sizes")
+            cache_sizes = parse_list( option, argv[ i + 1]);
+        else if ( option == "--ways")
+            associativities = parse_list( option, argv[ i + 1]);
+        else if ( option == "--line-sizes")
+            line_sizes = parse_list( option, argv[ i + 1]);
+        else if ( option == "--threads")
         {
-            CacheTagArray cta( 1024 * cache_size, associativity);
-            uint64 hit = 0, miss = 0;
-            while ( file_in >> hex >> addr) // while file contains addresses
+            const auto value = parse_list( option, argv[ i + 1]);
+            if ( value.size() != 1)
             {
-                if ( cta.read( addr).first) // hit
-                {
-                    hit++;
-                } else // miss
-                {
-                    miss++;
-                    cta.write( addr); // load to the cache
-                }
+                cerr << "ERROR: Wrong value " << argv[ i + 1] << " of " << option << " option!" << endl;
+                exit( EXIT_FAILURE);
             }
-            file_in.clear(); // reset "EOF" flag on file stream
-            file_in.seekg( ifstream::beg); // set file pointer to the beginning
-            double rate = 1.0 * miss / ( hit + miss);
-            file_out << rate << ", ";
-            file_out.flush(); // immidiate print to the file (to avoid delays)
+            num_threads = value.front();
+        }
+        else if ( option == "--types")
+            types = AccessTypes::parse( argv[ i + 1]);
+        else
+        {
+            cerr << "ERROR: Unknown option " << option << "!" << endl;
+            exit( EXIT_FAILURE);
         }
-        file_out << endl;
     }
-    /* Same as previous for full-associative cache. */
-    for ( auto cache_size : cache_sizes)
+
+    /* Open and check output file. */
+    ofstream file_out;
+    file_out.open( argv[ 2], ofstream::out);
+    if ( !file_out.is_open())
     {
-        CacheTagArray cta( 1024 * cache_size, 1024 * cache_size / 4);
-        uint64 hit = 0, miss = 0;
-        while ( file_in >> hex >> addr)
-        {
-            if ( cta.read( addr).first)
-            {
-                hit++;
-            } else
+        cerr << "ERROR: Can't open the output file!" << endl;
+        exit( EXIT_FAILURE);
+    }
+
+    /* Configurations in order of output. */
+    vector<Configuration> configs;
+    for ( auto line_size : line_sizes)
+        for ( auto associativity : associativities)
+            for ( auto cache_size : cache_sizes)
+                configs.push_back( { line_size, cache_size, associativity, 0});
+
+    /*
+     * Caches with the same line size and number of sets share one profiler,
+     * and so do all the full-associative caches with the same line size.
+     */
+    map<pair<uint32, uint32>, vector<Configuration*>> groups;
+    for ( auto& config : configs)
+    {
+        const uint32 num_sets = get_num_sets( config);
+        const uint32 key = config.ways == FULLY_ASSOCIATIVE ? FULLY_ASSOCIATIVE : num_sets;
+        groups[ make_pair( config.line_size, key)].push_back( &config);
+    }
+
+    const Trace trace( argv[ 1], types);
+
+    /* Each group is simulated by its own thread, results are written to its configurations only. */
+    ThreadPool pool( num_threads);
+    for ( const auto& group : groups)
+        pool.submit( [&trace, &group]() {
+            const uint32 line_size = group.first.first;
+            const uint32 num_sets = group.first.second;
+            if ( num_sets == FULLY_ASSOCIATIVE)
             {
-                miss++;
-                cta.write( addr);
+                ReuseDistanceProfiler profiler( line_size);
+                for ( size_t i = 0; i < trace.size(); ++i)
+                    if ( trace.is_selected( i))
+                        profiler.access( trace.get_addr( i));
+
+                for ( auto* config : group.second)
+                    config->misses = profiler.get_misses( 1024 * config->size_in_kbytes / line_size);
+                return;
             }
-        }
-        file_in.clear();
-        file_in.seekg( ifstream::beg);
-        double rate = 1.0 * miss / ( hit + miss);
+
+            uint32 max_ways = 0;
+            for ( const auto* config : group.second)
+                max_ways = max( max_ways, config->ways);
+
+            StackDistanceProfiler profiler( line_size, num_sets, max_ways);
+            for ( size_t i = 0; i < trace.size(); ++i)
+                if ( trace.is_selected( i))
+                    profiler.access( trace.get_addr( i));
+
+            for ( auto* config : group.second)
+                config->misses = profiler.get_misses( config->ways);
+        });
+    pool.wait();
+
+    const size_t table_size = associativities.size() * cache_sizes.size();
+    for ( size_t i = 0; i < configs.size(); ++i)
+    {
+        /* tables of several line sizes are told apart by titles */
+        if ( line_sizes.size() > 1 && i % table_size == 0)
+            file_out << "line size " << configs[ i].line_size << " bytes" << endl;
+
+        double rate = 1.0 * configs[ i].misses / trace.get_num_accesses();
         file_out << rate << ", ";
-        file_out.flush();
+        if ( ( i + 1) % cache_sizes.size() == 0) // end of row
+            file_out << endl;
     }
-    file_out << endl;
 
-    /* Close files. */
-    file_in.close();
+    /* Close file. */
     file_out.close();
     return 0;
 }
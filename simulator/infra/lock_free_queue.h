@@ -0,0 +1,108 @@
+/**
+ * lock_free_queue.h - bounded multi-producer multi-consumer queue
+ * Implementation follows the algorithm of Dmitry Vyukov:
+ * each cell carries a sequence number which tells
+ * whether the cell is ready to be written or to be read.
+ * Copyright 2017 MIPT-MIPS team
+ */
+
+#ifndef LOCK_FREE_QUEUE_H
+#define LOCK_FREE_QUEUE_H
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+#include <infra/macro.h>
+
+template<typename T, size_t N>
+class LockFreeQueue
+{
+    static_assert( is_power_of_two( N), "Size of LockFreeQueue should be a power of 2");
+
+    struct Cell
+    {
+        std::atomic<size_t> sequence = {};
+        T data = {};
+    };
+
+    /* positions are placed into different cache lines to avoid false sharing */
+    static const constexpr size_t cache_line_size = 64;
+
+    std::array<Cell, N> cells = {};
+    alignas( cache_line_size) std::atomic<size_t> enqueue_pos = {};
+    alignas( cache_line_size) std::atomic<size_t> dequeue_pos = {};
+
+    static ptrdiff_t distance( size_t sequence, size_t pos)
+    {
+        return static_cast<ptrdiff_t>( sequence) - static_cast<ptrdiff_t>( pos);
+    }
+
+public:
+    LockFreeQueue()
+    {
+        for ( size_t i = 0; i < N; ++i)
+            cells[ i].sequence.store( i, std::memory_order_relaxed);
+    }
+
+    LockFreeQueue( const LockFreeQueue&) = delete;
+    LockFreeQueue& operator=( const LockFreeQueue&) = delete;
+
+    /* returns false if queue is full */
+    bool push( const T& value)
+    {
+        size_t pos = enqueue_pos.load( std::memory_order_relaxed);
+        while ( true)
+        {
+            Cell& cell = cells[ pos & ( N - 1)];
+            const auto diff = distance( cell.sequence.load( std::memory_order_acquire), pos);
+            if ( diff == 0)
+            {
+                if ( enqueue_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed))
+                {
+                    cell.data = value;
+                    cell.sequence.store( pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if ( diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueue_pos.load( std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /* returns false if queue is empty */
+    bool pop( T* value)
+    {
+        size_t pos = dequeue_pos.load( std::memory_order_relaxed);
+        while ( true)
+        {
+            Cell& cell = cells[ pos & ( N - 1)];
+            const auto diff = distance( cell.sequence.load( std::memory_order_acquire), pos + 1);
+            if ( diff == 0)
+            {
+                if ( dequeue_pos.compare_exchange_weak( pos, pos + 1, std::memory_order_relaxed))
+                {
+                    *value = cell.data;
+                    cell.sequence.store( pos + N, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if ( diff < 0)
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeue_pos.load( std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+#endif // LOCK_FREE_QUEUE_H
@@ -0,0 +1,186 @@
+/**
+ * log.cpp - buffered sink of standard output
+ * Copyright 2017 MIPT-MIPS team
+ */
+
+// Generic C
+#include <cstdio>
+
+// Generic C++
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+// MIPT-MIPS modules
+#include "lock_free_queue.h"
+#include "log.h"
+
+namespace {
+
+using Buffer = std::vector<char>;
+
+/*
+ * Background thread writing filled buffers to stdout.
+ * It is created on the first hand-over, so simulations without
+ * any output do not start a thread.
+ */
+class LogWriter
+{
+    static const constexpr size_t queue_size = 64;
+
+    LockFreeQueue<Buffer*, queue_size> queue;
+    std::atomic<size_t> pending = {}; // buffers which are not written yet
+    std::atomic<bool> is_stopped = {};
+    std::thread thread; // the last member, as it uses all the previous ones
+
+    static std::atomic<bool>& started()
+    {
+        static std::atomic<bool> instance( false);
+        return instance;
+    }
+
+    void write( Buffer* buffer)
+    {
+        std::fwrite( buffer->data(), sizeof( char), buffer->size(), stdout);
+        delete buffer;
+        pending.fetch_sub( 1, std::memory_order_release);
+    }
+
+    void loop()
+    {
+        Buffer* buffer = nullptr;
+        while ( !is_stopped.load( std::memory_order_acquire))
+        {
+            if ( queue.pop( &buffer))
+                write( buffer);
+            else
+                std::this_thread::sleep_for( std::chrono::microseconds( 100));
+        }
+
+        /* everything pushed before the stop is visible now */
+        while ( queue.pop( &buffer))
+            write( buffer);
+
+        std::fflush( stdout);
+    }
+
+    LogWriter() : queue(), thread( [this]() { loop(); })
+    {
+        started() = true;
+    }
+
+public:
+    ~LogWriter()
+    {
+        is_stopped.store( true, std::memory_order_release);
+        thread.join();
+    }
+
+    LogWriter( const LogWriter&) = delete;
+    LogWriter& operator=( const LogWriter&) = delete;
+
+    static LogWriter& instance()
+    {
+        static LogWriter writer;
+        return writer;
+    }
+
+    static bool is_started() { return started(); }
+
+    void push( Buffer* buffer)
+    {
+        pending.fetch_add( 1, std::memory_order_relaxed);
+
+        /* writer is too slow, so we have to wait */
+        while ( !queue.push( buffer))
+            std::this_thread::yield();
+    }
+
+    void wait() const
+    {
+        while ( pending.load( std::memory_order_acquire) != 0)
+            std::this_thread::yield();
+
+        std::fflush( stdout);
+    }
+};
+
+/*
+ * Stream buffer which passes its content to writer
+ * only when it is full. Flushes (e.g. by std::endl) are ignored.
+ */
+class LogBuffer : public std::streambuf
+{
+    static const constexpr size_t capacity = 1ull << 16;
+
+    std::unique_ptr<Buffer> buffer = nullptr;
+
+    void reset()
+    {
+        buffer = std::make_unique<Buffer>( capacity);
+        setp( buffer->data(), buffer->data() + buffer->size());
+    }
+
+protected:
+    int_type overflow( int_type ch) final
+    {
+        hand_over();
+        if ( !traits_type::eq_int_type( ch, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type( ch);
+            pbump( 1);
+        }
+        return traits_type::not_eof( ch);
+    }
+
+    int sync() final { return 0; }
+
+public:
+    LogBuffer() { reset(); }
+    ~LogBuffer() final { hand_over(); }
+
+    LogBuffer( const LogBuffer&) = delete;
+    LogBuffer& operator=( const LogBuffer&) = delete;
+
+    void hand_over()
+    {
+        const auto size = static_cast<size_t>( pptr() - pbase());
+        if ( size == 0)
+            return;
+
+        buffer->resize( size);
+        LogWriter::instance().push( buffer.release());
+        reset();
+    }
+};
+
+struct ThreadSink
+{
+    LogBuffer buffer = {};
+    std::ostream stream;
+
+    ThreadSink() : stream( &buffer) { }
+
+    static ThreadSink& get()
+    {
+        static thread_local ThreadSink instance;
+        return instance;
+    }
+};
+
+} // namespace
+
+std::ostream& LogSink::stream()
+{
+    return ThreadSink::get().stream;
+}
+
+void LogSink::drain()
+{
+    ThreadSink::get().buffer.hand_over();
+    if ( LogWriter::is_started())
+        LogWriter::instance().wait();
+}
@@ -10,6 +10,30 @@
 
 #include <iostream>
 #include <ostream>
+#include <type_traits>
+
+/* Detailed output is compiled only in tracing builds (make TRACE=1) */
+#ifdef ENABLE_TRACE
+static const constexpr bool trace_enabled = true;
+#else
+static const constexpr bool trace_enabled = false;
+#endif
+
+/*
+ * Buffered sink of standard output.
+ * Each thread formats its output into its own buffer, and filled buffers
+ * are written by a background thread, so neither formatting nor std::endl
+ * waits for I/O.
+ */
+class LogSink
+{
+public:
+    /* stream of the calling thread */
+    static std::ostream& stream();
+
+    /* hands all buffered data to the writer and waits till it is written */
+    static void drain();
+};
 
 class LogOstream
 {
@@ -41,14 +65,36 @@ public:
     }
 };
 
+/*
+ * Stream of non-tracing builds, all the output operations are no-op.
+ * Trace statements are guarded by "if constexpr ( trace_enabled)",
+ * so their arguments are not evaluated either.
+ */
+class NullOstream
+{
+public:
+    NullOstream(bool /* unused */, std::ostream& /* unused */) { }
+
+    NullOstream& operator<<(std::ostream& (* /* unused */)(std::ostream&)) { return *this; }
+
+    template<typename T>
+    NullOstream& operator<<(const T& /* unused */) { return *this; }
+};
+
+using TraceOstream = std::conditional_t<trace_enabled, LogOstream, NullOstream>;
+
 class Log
 {
+    static std::ostream& trace_stream(bool value) {
+        return trace_enabled && value ? LogSink::stream() : std::cout;
+    }
+
 public:
-    mutable LogOstream sout;
+    mutable TraceOstream sout;
     mutable LogOstream serr;
     const LogOstream::Critical critical;
 
-    explicit Log(bool value) : sout(value, std::cout), serr(true, std::cerr), critical() { }
+    explicit Log(bool value) : sout(value, trace_stream(value)), serr(true, std::cerr), critical() { }
     virtual ~Log() = default;
 
     Log( const Log&) = delete;
@@ -11,6 +11,8 @@
 
 #include <algorithm>
 
+#include <infra/types.h>
+
 /* Returns size of a static array */
 template<typename T, size_t N>
 constexpr size_t countof( const T (& /* unused */)[N]) noexcept { return N; }
@@ -19,6 +21,29 @@ constexpr size_t countof( const T (& /* unused */)[N]) noexcept { return N; }
 template<typename T>
 constexpr bool is_power_of_two( const T& n) noexcept { return (n & (n - 1)) == 0; }
 
+/* Returns number of trailing zero bits, value should be not zero */
+inline uint32 count_trailing_zeros( uint32 value) noexcept
+{
+#if defined(__GNUC__)
+    return static_cast<uint32>( __builtin_ctz( value));
+#else
+    uint32 result = 0;
+    for ( ; ( value & 1) == 0; value >>= 1)
+        ++result;
+    return result;
+#endif
+}
+
+/* Returns binary logarithm rounded down, zero for zero */
+constexpr uint32 log_bin( uint32 value) noexcept
+{
+    uint32 result = 0;
+    while ( ( value >>= 1) != 0)
+        ++result;
+
+    return result;
+}
+
 /* Ignore return value */
 template<typename T>
 void ignored( const T& /* unused */) noexcept { }
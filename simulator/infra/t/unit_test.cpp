@@ -0,0 +1,81 @@
+// generic C++
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Module
+#include "../macro.h"
+#include "../thread_pool.h"
+
+TEST( Macro, Log_Bin)
+{
+    ASSERT_EQ( log_bin( 0), 0u);
+    ASSERT_EQ( log_bin( 1), 0u);
+    ASSERT_EQ( log_bin( 1024), 10u);
+    ASSERT_EQ( log_bin( 1023), 9u);
+    ASSERT_EQ( log_bin( 0x80000000u), 31u);
+}
+
+TEST( ThreadPool, Size)
+{
+    ASSERT_EQ( ThreadPool( 3).size(), 3u);
+    ASSERT_GE( ThreadPool().size(), 1u);
+}
+
+TEST( ThreadPool, Submit_And_Wait)
+{
+    // single thread takes tasks in order of submission
+    ThreadPool pool( 1);
+    std::vector<int> order;
+    for ( int i = 0; i < 100; ++i)
+        pool.submit( [&order, i]() { order.push_back( i); });
+    pool.wait();
+
+    ASSERT_EQ( order.size(), 100u);
+    for ( int i = 0; i < 100; ++i)
+        ASSERT_EQ( order[ i], i);
+}
+
+TEST( ThreadPool, Reuse_After_Wait)
+{
+    ThreadPool pool( 4);
+    std::atomic<int> done( 0);
+    for ( int round = 1; round <= 3; ++round)
+    {
+        for ( int i = 0; i < 50; ++i)
+            pool.submit( [&done]() { ++done; });
+        pool.wait();
+        ASSERT_EQ( done, 50 * round);
+    }
+
+    // waiting without tasks returns at once
+    pool.wait();
+    ASSERT_EQ( done, 150);
+}
+
+TEST( ThreadPool, Destruction_With_Pending_Tasks)
+{
+    std::atomic<int> done( 0);
+    {
+        ThreadPool pool( 2);
+        for ( int i = 0; i < 20; ++i)
+            pool.submit( [&done]() {
+                std::this_thread::sleep_for( std::chrono::milliseconds( 1));
+                ++done;
+            });
+    }
+
+    // the pool finishes the submitted tasks before its threads are joined
+    ASSERT_EQ( done, 20);
+}
+
+int main( int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, argv);
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    return RUN_ALL_TESTS();
+}
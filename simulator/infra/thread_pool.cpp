@@ -0,0 +1,68 @@
+/**
+ * thread_pool.cpp - fixed set of threads running independent tasks
+ * Copyright 2017 MIPT-MIPS team
+ */
+
+#include <algorithm>
+#include <utility>
+
+#include "thread_pool.h"
+
+ThreadPool::ThreadPool( uint32 num_threads)
+{
+    if ( num_threads == 0)
+        num_threads = std::max( std::thread::hardware_concurrency(), 1u);
+
+    for ( uint32 i = 0; i < num_threads; ++i)
+        threads.emplace_back( [this]() { loop(); });
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex);
+        is_stopped = true;
+    }
+    has_task.notify_all();
+
+    for ( auto& thread : threads)
+        thread.join();
+}
+
+void ThreadPool::loop()
+{
+    std::unique_lock<std::mutex> lock( mutex);
+    while ( true)
+    {
+        has_task.wait( lock, [this]() { return is_stopped || !tasks.empty(); });
+        if ( tasks.empty())
+            return;
+
+        auto task = std::move( tasks.front());
+        tasks.pop_front();
+        ++running;
+
+        lock.unlock();
+        task();
+        lock.lock();
+
+        --running;
+        if ( running == 0 && tasks.empty())
+            is_idle.notify_all();
+    }
+}
+
+void ThreadPool::submit( std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock( mutex);
+        tasks.push_back( std::move( task));
+    }
+    has_task.notify_one();
+}
+
+void ThreadPool::wait()
+{
+    std::unique_lock<std::mutex> lock( mutex);
+    is_idle.wait( lock, [this]() { return running == 0 && tasks.empty(); });
+}
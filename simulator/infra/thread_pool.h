@@ -0,0 +1,50 @@
+/**
+ * thread_pool.h - fixed set of threads running independent tasks
+ * Copyright 2017 MIPT-MIPS team
+ */
+
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <infra/types.h>
+
+/*
+ * Tasks are coarse (whole simulations), so they are taken
+ * from the common queue under the lock.
+ */
+class ThreadPool
+{
+    std::vector<std::thread> threads = {};
+    std::deque<std::function<void()>> tasks = {};
+
+    std::mutex mutex = {};
+    std::condition_variable has_task = {};
+    std::condition_variable is_idle = {};
+    size_t running = 0;
+    bool is_stopped = false;
+
+    void loop();
+
+public:
+    /* zero means number of hardware threads */
+    explicit ThreadPool( uint32 num_threads = 0);
+    ~ThreadPool();
+
+    ThreadPool( const ThreadPool&) = delete;
+    ThreadPool& operator=( const ThreadPool&) = delete;
+
+    size_t size() const { return threads.size(); }
+
+    void submit( std::function<void()> task);
+    /* waits till all the submitted tasks are done */
+    void wait();
+};
+
+#endif // THREAD_POOL_H
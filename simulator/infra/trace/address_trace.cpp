@@ -0,0 +1,118 @@
+/*
+ * address_trace.cpp - binary traces of memory addresses
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C generic modules */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+/* C++ generic modules */
+#include <array>
+#include <iostream>
+#include <sstream>
+
+/* MIPT-MIPS modules */
+#include "address_trace.h"
+
+static const std::array<char, 4> MAGIC = {{ 'A', 'T', 'R', 'C' }};
+static const uint8 VERSION = 1;
+static const size_t HEADER_SIZE = 8;
+static const uint8 FLAG_HAS_TYPES = 1;
+
+AccessTypes AccessTypes::parse( const std::string& list)
+{
+    AccessTypes types;
+    std::istringstream stream( list);
+    std::string item;
+    while ( std::getline( stream, item, ','))
+    {
+        if ( item == "load")
+            types.add( AccessType::LOAD);
+        else if ( item == "store")
+            types.add( AccessType::STORE);
+        else if ( item == "fetch")
+            types.add( AccessType::FETCH);
+        else
+        {
+            std::cerr << "ERROR: Unknown access type " << item
+                      << ", it should be load, store or fetch" << std::endl;
+            std::exit( EXIT_FAILURE);
+        }
+    }
+
+    if ( types.empty())
+    {
+        std::cerr << "ERROR: List of access types is empty" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    return types;
+}
+
+AddressTraceWriter::AddressTraceWriter( const std::string& filename, uint32 addr_bytes, bool has_types)
+    : file( filename, std::ios::binary)
+    , addr_bytes( addr_bytes)
+    , has_types( has_types)
+{
+    if ( addr_bytes != 4 && addr_bytes != 8)
+    {
+        std::cerr << "ERROR: Address size in trace should be 4 or 8 bytes" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( !file.is_open())
+    {
+        std::cerr << "ERROR: Could not open file " << filename << ": "
+                  << std::strerror( errno) << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    const std::array<char, HEADER_SIZE> header = {{ MAGIC[ 0], MAGIC[ 1], MAGIC[ 2], MAGIC[ 3],
+                                                   static_cast<char>( VERSION),
+                                                   static_cast<char>( addr_bytes),
+                                                   static_cast<char>( has_types ? FLAG_HAS_TYPES : 0),
+                                                   0 }};
+    file.write( header.data(), header.size());
+}
+
+void AddressTraceWriter::write( uint64 addr, AccessType type)
+{
+    std::array<char, 9> record = {};
+    for ( uint32 i = 0; i < addr_bytes; ++i)
+        record[ i] = static_cast<char>( addr >> ( 8 * i));
+
+    if ( has_types)
+        record[ addr_bytes] = static_cast<char>( type);
+
+    file.write( record.data(), addr_bytes + ( has_types ? 1 : 0));
+}
+
+bool AddressTrace::is_address_trace( const std::string& filename)
+{
+    std::ifstream file( filename, std::ios::binary);
+    std::array<char, MAGIC.size()> magic = {};
+    return file.read( magic.data(), magic.size()) && magic == MAGIC;
+}
+
+AddressTrace::AddressTrace( const std::string& filename) : file( filename)
+{
+    const uint8* header = file.data();
+    if ( file.size() < HEADER_SIZE || std::memcmp( header, MAGIC.data(), MAGIC.size()) != 0)
+    {
+        std::cerr << "ERROR: " << filename << " is not an address trace" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( header[ 4] != VERSION || ( header[ 5] != 4 && header[ 5] != 8))
+    {
+        std::cerr << "ERROR: Unsupported format of address trace " << filename << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    addr_bytes = header[ 5];
+    has_types = ( header[ 6] & FLAG_HAS_TYPES) != 0;
+    data = header + HEADER_SIZE;
+    num_records = ( file.size() - HEADER_SIZE) / ( addr_bytes + ( has_types ? 1 : 0));
+}
@@ -0,0 +1,100 @@
+/*
+ * address_trace.h - binary traces of memory addresses
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef ADDRESS_TRACE_H
+#define ADDRESS_TRACE_H
+
+/* C++ libraries. */
+#include <fstream>
+#include <string>
+
+/* Simulator modules. */
+#include <infra/types.h>
+
+#include "mapped_file.h"
+
+/*
+ * Trace starts with 8-byte header:
+ *     "ATRC", version, size of address in bytes (4 or 8), flags, zero byte.
+ * Each record is little-endian address followed by access type byte,
+ * if bit 0 of flags is set.
+ */
+enum class AccessType : uint8
+{
+    LOAD,
+    STORE,
+    FETCH
+};
+
+/* set of access types selected from trace, e.g. by "load,store" list */
+class AccessTypes
+{
+    uint8 mask = 0;
+
+public:
+    /* exits on unknown type name, which is "load", "store" or "fetch" */
+    static AccessTypes parse( const std::string& list);
+
+    void add( AccessType type) { mask |= 1u << static_cast<uint8>( type); }
+    bool contains( AccessType type) const { return ( mask & ( 1u << static_cast<uint8>( type))) != 0; }
+    bool empty() const { return mask == 0; }
+};
+
+class AddressTraceWriter
+{
+    std::ofstream file;
+    const uint32 addr_bytes;
+    const bool has_types;
+
+public:
+    AddressTraceWriter( const std::string& filename, uint32 addr_bytes, bool has_types);
+
+    void write( uint64 addr, AccessType type = AccessType::LOAD);
+};
+
+/*
+ * Trace is mapped into memory and read in place,
+ * so many readers may share it without copies.
+ */
+class AddressTrace
+{
+    const MappedFile file;
+    const uint8* data = nullptr; // the first record
+    size_t num_records = 0;
+    uint32 addr_bytes = 0;
+    bool has_types = false;
+
+public:
+    explicit AddressTrace( const std::string& filename);
+
+    AddressTrace( const AddressTrace&) = delete;
+    AddressTrace& operator=( const AddressTrace&) = delete;
+
+    /* checks whether the file starts with the trace header */
+    static bool is_address_trace( const std::string& filename);
+
+    size_t size() const { return num_records; }
+    bool has_access_types() const { return has_types; }
+
+    uint64 get_addr( size_t index) const
+    {
+        const uint8* record = data + index * ( addr_bytes + ( has_types ? 1 : 0));
+        uint64 addr = 0;
+        for ( uint32 i = 0; i < addr_bytes; ++i)
+            addr |= uint64{ record[ i]} << ( 8 * i);
+
+        return addr;
+    }
+
+    AccessType get_type( size_t index) const
+    {
+        if ( !has_types)
+            return AccessType::LOAD;
+
+        return static_cast<AccessType>( data[ index * ( addr_bytes + 1) + addr_bytes]);
+    }
+};
+
+#endif // ADDRESS_TRACE_H
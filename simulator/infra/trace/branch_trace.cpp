@@ -0,0 +1,65 @@
+/*
+ * branch_trace.cpp - binary traces of branch outcomes
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C generic modules */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+/* C++ generic modules */
+#include <array>
+#include <iostream>
+
+/* MIPT-MIPS modules */
+#include "branch_trace.h"
+
+static const std::array<char, 4> MAGIC = {{ 'B', 'T', 'R', 'C' }};
+static const uint8 VERSION = 2;
+static const size_t HEADER_SIZE = 8;
+
+BranchTraceWriter::BranchTraceWriter( const std::string& filename)
+    : file( filename, std::ios::binary)
+{
+    if ( !file.is_open())
+    {
+        std::cerr << "ERROR: Could not open file " << filename << ": "
+                  << std::strerror( errno) << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    const std::array<char, HEADER_SIZE> header = {{ MAGIC[ 0], MAGIC[ 1], MAGIC[ 2], MAGIC[ 3],
+                                                   static_cast<char>( VERSION), 0, 0, 0 }};
+    file.write( header.data(), header.size());
+}
+
+void BranchTraceWriter::write( Addr PC, uint32 raw, bool is_taken, Addr target)
+{
+    const std::array<uint32, 4> words = {{ PC, target, raw, ( instructions & 0x7fffffffu) | ( is_taken ? 0x80000000u : 0u) }};
+    std::array<char, 16> record = {};
+    for ( size_t i = 0; i < record.size(); ++i)
+        record[ i] = static_cast<char>( words[ i / 4] >> ( 8 * ( i % 4)));
+
+    file.write( record.data(), record.size());
+    instructions = 0;
+}
+
+BranchTrace::BranchTrace( const std::string& filename) : file( filename)
+{
+    const uint8* header = file.data();
+    if ( file.size() < HEADER_SIZE || std::memcmp( header, MAGIC.data(), MAGIC.size()) != 0)
+    {
+        std::cerr << "ERROR: " << filename << " is not a branch trace" << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    if ( header[ 4] != VERSION)
+    {
+        std::cerr << "ERROR: Unsupported format of branch trace " << filename << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    data = header + HEADER_SIZE;
+    num_records = ( file.size() - HEADER_SIZE) / RECORD_SIZE;
+}
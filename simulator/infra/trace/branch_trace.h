@@ -0,0 +1,68 @@
+/*
+ * branch_trace.h - binary traces of branch outcomes
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef BRANCH_TRACE_H
+#define BRANCH_TRACE_H
+
+/* C++ libraries. */
+#include <fstream>
+#include <string>
+
+/* Simulator modules. */
+#include <infra/types.h>
+
+#include "mapped_file.h"
+
+/*
+ * Trace starts with 8-byte header: "BTRC", version, three zero bytes.
+ * Each record is 16 bytes of little-endian 32-bit words:
+ *     PC of branch, its target, the instruction itself
+ *     (so calls, returns and indirect jumps can be told apart by pre-decoding),
+ *     number of instructions since the previous record (including the branch)
+ *     with the outcome of the branch in bit 31.
+ */
+class BranchTraceWriter
+{
+    std::ofstream file;
+    uint32 instructions = 0;
+
+public:
+    explicit BranchTraceWriter( const std::string& filename);
+
+    /* counts an instruction executed before the next branch */
+    void add_instruction() { ++instructions; }
+    void write( Addr PC, uint32 raw, bool is_taken, Addr target);
+};
+
+class BranchTrace
+{
+    static const size_t RECORD_SIZE = 16;
+
+    const MappedFile file;
+    const uint8* data = nullptr; // the first record
+    size_t num_records = 0;
+
+    uint32 get_word( size_t index, size_t offset) const
+    {
+        const uint8* word = data + index * RECORD_SIZE + offset;
+        return uint32{ word[ 0]} | uint32{ word[ 1]} << 8 | uint32{ word[ 2]} << 16 | uint32{ word[ 3]} << 24;
+    }
+
+public:
+    explicit BranchTrace( const std::string& filename);
+
+    BranchTrace( const BranchTrace&) = delete;
+    BranchTrace& operator=( const BranchTrace&) = delete;
+
+    size_t size() const { return num_records; }
+
+    Addr get_PC( size_t index) const { return get_word( index, 0); }
+    Addr get_target( size_t index) const { return get_word( index, 4); }
+    uint32 get_raw( size_t index) const { return get_word( index, 8); }
+    bool is_taken( size_t index) const { return ( get_word( index, 12) >> 31) != 0; }
+    uint32 get_instructions( size_t index) const { return get_word( index, 12) & 0x7fffffffu; }
+};
+
+#endif // BRANCH_TRACE_H
@@ -0,0 +1,75 @@
+/*
+ * mapped_file.cpp - read-only file mapped into memory
+ * Copyright 2017 MIPT-MIPS
+ */
+
+/* C generic modules */
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+
+/* C++ generic modules */
+#include <fstream>
+#include <iostream>
+#include <iterator>
+
+/* POSIX */
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+/* MIPT-MIPS modules */
+#include "mapped_file.h"
+
+#if defined(_WIN32)
+MappedFile::MappedFile( const std::string& filename)
+{
+    std::ifstream file( filename, std::ios::binary);
+    if ( !file.is_open())
+    {
+        std::cerr << "ERROR: Could not open file " << filename << ": "
+                  << std::strerror( errno) << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    buffer.assign( std::istreambuf_iterator<char>( file), std::istreambuf_iterator<char>());
+    mapping_size = buffer.size();
+}
+
+MappedFile::~MappedFile() = default;
+#else
+MappedFile::MappedFile( const std::string& filename)
+{
+    const int fd = open( filename.c_str(), O_RDONLY);
+    struct stat info = {};
+    if ( fd < 0 || fstat( fd, &info) != 0)
+    {
+        std::cerr << "ERROR: Could not open file " << filename << ": "
+                  << std::strerror( errno) << std::endl;
+        std::exit( EXIT_FAILURE);
+    }
+
+    mapping_size = static_cast<size_t>( info.st_size);
+    if ( mapping_size != 0)
+    {
+        mapping = mmap( nullptr, mapping_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if ( mapping == MAP_FAILED) // NOLINT
+        {
+            std::cerr << "ERROR: Could not map file " << filename << ": "
+                      << std::strerror( errno) << std::endl;
+            std::exit( EXIT_FAILURE);
+        }
+        madvise( mapping, mapping_size, MADV_SEQUENTIAL);
+    }
+    close( fd);
+}
+
+MappedFile::~MappedFile()
+{
+    if ( mapping != nullptr)
+        munmap( mapping, mapping_size);
+}
+#endif
@@ -0,0 +1,37 @@
+/*
+ * mapped_file.h - read-only file mapped into memory
+ * Copyright 2017 MIPT-MIPS
+ */
+
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+/* C++ libraries. */
+#include <string>
+#include <vector>
+
+/* Simulator modules. */
+#include <infra/types.h>
+
+/*
+ * Traces are read in place, so many readers may share them without copies.
+ * The file is read into a buffer where mmap is not available.
+ */
+class MappedFile
+{
+    void* mapping = nullptr;
+    size_t mapping_size = 0;
+    std::vector<uint8> buffer = {};
+
+public:
+    explicit MappedFile( const std::string& filename);
+    ~MappedFile();
+
+    MappedFile( const MappedFile&) = delete;
+    MappedFile& operator=( const MappedFile&) = delete;
+
+    const uint8* data() const { return mapping != nullptr ? static_cast<const uint8*>( mapping) : buffer.data(); }
+    size_t size() const { return mapping_size; }
+};
+
+#endif // MAPPED_FILE_H
@@ -0,0 +1,125 @@
+// generic C
+#include <cstdio>
+#include <cstdlib>
+
+// generic C++
+#include <fstream>
+
+// Google Test library
+#include <gtest/gtest.h>
+
+// Module
+#include "../address_trace.h"
+#include "../branch_trace.h"
+
+static const std::string trace_file = "./test.trace";
+
+TEST( AddressTrace, Addresses_With_Types)
+{
+    {
+        AddressTraceWriter writer( trace_file, 4, true);
+        writer.write( 0x4000f0, AccessType::FETCH);
+        writer.write( 0x10008000, AccessType::LOAD);
+        writer.write( 0xfffffffc, AccessType::STORE);
+    }
+
+    ASSERT_TRUE( AddressTrace::is_address_trace( trace_file));
+    const AddressTrace trace( trace_file);
+    ASSERT_EQ( trace.size(), 3u);
+    ASSERT_TRUE( trace.has_access_types());
+    ASSERT_EQ( trace.get_addr( 0), 0x4000f0u);
+    ASSERT_EQ( trace.get_type( 0), AccessType::FETCH);
+    ASSERT_EQ( trace.get_addr( 1), 0x10008000u);
+    ASSERT_EQ( trace.get_type( 1), AccessType::LOAD);
+    ASSERT_EQ( trace.get_addr( 2), 0xfffffffcu);
+    ASSERT_EQ( trace.get_type( 2), AccessType::STORE);
+
+    std::remove( trace_file.c_str());
+}
+
+TEST( AddressTrace, Wide_Addresses)
+{
+    {
+        AddressTraceWriter writer( trace_file, 8, false);
+        writer.write( 0x123456789abcdef0);
+        writer.write( 0x40);
+    }
+
+    const AddressTrace trace( trace_file);
+    ASSERT_EQ( trace.size(), 2u);
+    ASSERT_FALSE( trace.has_access_types());
+    ASSERT_EQ( trace.get_addr( 0), 0x123456789abcdef0u);
+    ASSERT_EQ( trace.get_addr( 1), 0x40u);
+
+    std::remove( trace_file.c_str());
+}
+
+TEST( AddressTrace, Wrong_Files)
+{
+    std::ofstream( trace_file) << "4000f0\n400100\n";
+    ASSERT_FALSE( AddressTrace::is_address_trace( trace_file));
+    ASSERT_EXIT( AddressTrace trace( trace_file), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    std::remove( trace_file.c_str());
+
+    ASSERT_EXIT( AddressTrace trace( "./1234567890/qwertyuiop"), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( AddressTraceWriter writer( trace_file, 2, false), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( AddressTrace, Access_Types)
+{
+    const auto types = AccessTypes::parse( "load,fetch");
+    ASSERT_TRUE( types.contains( AccessType::LOAD));
+    ASSERT_FALSE( types.contains( AccessType::STORE));
+    ASSERT_TRUE( types.contains( AccessType::FETCH));
+
+    ASSERT_EXIT( AccessTypes::parse( "load,write"), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( AccessTypes::parse( ""), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+TEST( BranchTrace, Branches)
+{
+    {
+        BranchTraceWriter writer( trace_file);
+        writer.add_instruction();
+        writer.add_instruction();
+        writer.write( 0x4000f0, 0x0c100040, true, 0x400100);
+        writer.add_instruction();
+        writer.write( 0x400104, 0x10220003, false, 0x400108);
+    }
+
+    ASSERT_FALSE( AddressTrace::is_address_trace( trace_file));
+    const BranchTrace trace( trace_file);
+    ASSERT_EQ( trace.size(), 2u);
+    ASSERT_EQ( trace.get_PC( 0), 0x4000f0u);
+    ASSERT_EQ( trace.get_target( 0), 0x400100u);
+    ASSERT_EQ( trace.get_raw( 0), 0x0c100040u);
+    ASSERT_TRUE( trace.is_taken( 0));
+    ASSERT_EQ( trace.get_instructions( 0), 2u);
+    ASSERT_EQ( trace.get_PC( 1), 0x400104u);
+    ASSERT_EQ( trace.get_target( 1), 0x400108u);
+    ASSERT_EQ( trace.get_raw( 1), 0x10220003u);
+    ASSERT_FALSE( trace.is_taken( 1));
+    ASSERT_EQ( trace.get_instructions( 1), 1u);
+
+    std::remove( trace_file.c_str());
+}
+
+TEST( BranchTrace, Wrong_Files)
+{
+    {
+        AddressTraceWriter writer( trace_file, 4, false);
+        writer.write( 0x4000f0);
+    }
+    ASSERT_EXIT( BranchTrace trace( trace_file), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    std::remove( trace_file.c_str());
+
+    ASSERT_EXIT( BranchTrace trace( "./1234567890/qwertyuiop"), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+    ASSERT_EXIT( BranchTraceWriter writer( "./1234567890/qwertyuiop"), ::testing::ExitedWithCode( EXIT_FAILURE), "ERROR.*");
+}
+
+int main( int argc, char* argv[])
+{
+    ::testing::InitGoogleTest( &argc, argv);
+    ::testing::FLAGS_gtest_death_test_style = "threadsafe";
+    return RUN_ALL_TESTS();
+}
@@ -13,8 +13,10 @@
 
 /* Simulator modules. */
 #include <infra/config/config.h>
+#include <infra/log.h>
 
 #include <func_sim/func_sim.h>
+#include <core/ooo_sim.h>
 #include <core/perf_sim.h>
 
 namespace config {
@@ -23,6 +25,9 @@ namespace config {
 
     static Value<bool> disassembly_on = { "disassembly,d", false, "print disassembly"};
     static Value<bool> functional_only = { "functional-only,f", false, "run functional simulation only"};
+    static Value<bool> out_of_order = { "out-of-order", false, "run out-of-order performance simulation"};
+    static Value<std::string> address_trace = { "address-trace", "", "write addresses of fetches, loads and stores of functional simulation to binary trace"};
+    static Value<std::string> branch_trace = { "branch-trace", "", "write branches of functional simulation to binary trace"};
 } // namespace config
 
 int main( int argc, char** argv)
@@ -30,17 +35,41 @@ int main( int argc, char** argv)
     /* Analysing and handling of inserted arguments */
     config::handleArgs( argc, argv);
 
+    if ( config::disassembly_on && !trace_enabled)
+        std::cerr << "WARNING. Detailed output is not compiled into this build, "
+                  << "use mipt-mips-trace built by 'make mipt-mips TRACE=1'" << std::endl;
+
+    const std::string& address_trace = config::address_trace;
+    if ( !address_trace.empty() && !config::functional_only)
+        std::cerr << "WARNING. Address trace is written only by functional simulation, "
+                  << "run it with -f option" << std::endl;
+
+    const std::string& branch_trace = config::branch_trace;
+    if ( !branch_trace.empty() && !config::functional_only)
+        std::cerr << "WARNING. Branch trace is written only by functional simulation, "
+                  << "run it with -f option" << std::endl;
+
     /* running simulation */
-    if ( !config::functional_only)
+    if ( config::functional_only)
     {
-        PerfMIPS p_mips( config::disassembly_on);
-        p_mips.run( config::binary_filename,
-                    config::num_steps);
+        MIPS mips( config::disassembly_on);
+        if ( !address_trace.empty())
+            mips.set_address_trace( address_trace);
+        if ( !branch_trace.empty())
+            mips.set_branch_trace( branch_trace);
+        mips.run( config::binary_filename, config::num_steps);
+    }
+    else if ( config::out_of_order)
+    {
+        OoOMIPS ooo_mips( config::disassembly_on);
+        ooo_mips.run( config::binary_filename,
+                      config::num_steps);
     }
     else
     {
-        MIPS mips( config::disassembly_on);
-        mips.run( config::binary_filename, config::num_steps);
+        PerfMIPS p_mips( config::disassembly_on);
+        p_mips.run( config::binary_filename,
+                    config::num_steps);
     }
 
     return 0;
@@ -209,6 +209,37 @@ FuncInstr::FuncInstr( uint32 bytes, Addr PC,
     new_PC = PC + 4;
 }
 
+bool FuncInstr::is_call( uint32 bytes)
+{
+    const _instr value( bytes);
+    if ( value.asR.opcode == 0x0)
+        return value.asR.funct == 0x9;
+
+    return value.asJ.opcode == 0x3;
+}
+
+bool FuncInstr::is_return( uint32 bytes)
+{
+    const _instr value( bytes);
+    return value.asR.opcode == 0x0 && value.asR.funct == 0x8 && value.asR.rs == REG_NUM_RA;
+}
+
+bool FuncInstr::is_indirect_jump( uint32 bytes)
+{
+    const _instr value( bytes);
+    return value.asR.opcode == 0x0 && ( value.asR.funct == 0x8 || value.asR.funct == 0x9);
+}
+
+bool FuncInstr::is_jump( uint32 bytes)
+{
+    if ( is_indirect_jump( bytes))
+        return true;
+
+    /* j, jal, beq, bne, blez, bgtz and their "likely" versions */
+    const uint32 opcode = _instr( bytes).asJ.opcode;
+    return ( opcode >= 0x2 && opcode <= 0x7) || ( opcode >= 0x14 && opcode <= 0x17);
+}
+
 void FuncInstr::initFormat()
 {
     bool is_R = ( instr.asR.opcode == 0x0);
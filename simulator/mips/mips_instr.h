@@ -185,6 +185,8 @@ class FuncInstr
         Addr PC = NO_VAL32; // removing "const" keyword to supporting ports
         Addr new_PC = NO_VAL32;
 
+        uint64 sequence_id = NO_VAL64; // program order number in the pipeline
+
         std::string disasm = "";
 
         void initFormat();
@@ -355,6 +357,16 @@ class FuncInstr
                                        operation == OUT_I_STORER ||
                                        operation == OUT_I_STOREL; }
         bool is_nop() const { return instr.raw == 0x0u; }
+        bool is_call() const { return is_call( instr.raw); }
+        bool is_return() const { return is_return( instr.raw); }
+        bool is_indirect_jump() const { return is_indirect_jump( instr.raw); }
+        bool is_unknown() const { return operation == OUT_UNKNOWN; }
+
+        /* pre-decoding for the front end, the instruction is not parsed yet */
+        static bool is_call( uint32 bytes);   // jal, jalr
+        static bool is_return( uint32 bytes); // jr $ra
+        static bool is_indirect_jump( uint32 bytes); // jr, jalr
+        static bool is_jump( uint32 bytes); // branches and jumps, as isJump()
 
         bool has_trap() const { return trap != TrapType::NO_TRAP; }
 
@@ -367,6 +379,10 @@ class FuncInstr
         uint32 get_mem_size() const { return mem_size; }
         Addr get_new_PC() const { return new_PC; }
         Addr get_PC() const { return PC; }
+        uint32 get_raw() const { return instr.raw; }
+
+        void set_sequence_id( uint64 id) { sequence_id = id; }
+        uint64 get_sequence_id() const { return sequence_id; }
 
         void set_v_dst(uint32 value); // for loads
         uint32 get_v_src2() const { return v_src2; } // for stores
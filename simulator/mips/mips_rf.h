@@ -21,11 +21,11 @@ class RF
              * For instance, when there is
              *    add $t0, $s1, $s2
              * instruction decoded, the register $t0 is marked "not valid".
-             * After writeback it becomes valid again, and till that moment no
-             * instruction with WAW or RAW dependency from register $t0 can be
-             * executed. The WAW dependency is just a workaround for #45 issue.
+             * After writeback it becomes valid again.
+             * As there may be several writing instructions in the pipeline,
+             * we count them instead of keeping a single flag.
              */
-            bool is_valid = true; 
+            uint32 writers = 0;
         };
         std::array<Reg, REG_NUM_MAX> array = {};
 
@@ -35,36 +35,37 @@ class RF
         void invalidate( RegNum num)
         {
             if ( num != REG_NUM_ZERO)
-                get_entry( num).is_valid = false;
+                ++get_entry( num).writers;
         }
 
         void validate( RegNum num)
         {
-            if ( num != REG_NUM_ZERO)
-                get_entry( num).is_valid = true;
+            if ( num == REG_NUM_ZERO)
+                return;
+            auto& entry = get_entry(num);
+            assert( entry.writers != 0);
+            --entry.writers;
         }
 
-        bool check( RegNum num) const
+        void write( RegNum num, uint32 val)
         {
-            return get_entry( num).is_valid;
+            if ( num == REG_NUM_ZERO)
+                return;
+            validate( num);
+            get_entry( num).value = val;
         }
+    public:
+        RF() = default;
 
-        uint32 read( RegNum num) const
+        bool check( RegNum num) const
         {
-            return get_entry( num).value;
+            return get_entry( num).writers == 0;
         }
 
-        void write( RegNum num, uint32 val)
+        uint32 read( RegNum num) const
         {
-            if ( num == REG_NUM_ZERO)
-                return;
-            auto& entry = get_entry(num);
-            assert( !entry.is_valid);
-            entry.is_valid = true;
-            entry.value = val;
+            return get_entry( num).value;
         }
-    public:
-        RF() = default;
 
         inline void read_sources( FuncInstr* instr)
         {
@@ -76,8 +77,7 @@ class RF
         inline bool check_sources( const FuncInstr& instr) const
         {
             return check( instr.get_src1_num())
-                && check( instr.get_src2_num())
-                && check( instr.get_dst_num());
+                && check( instr.get_src2_num());
         }
 
         inline void write_dst( const FuncInstr& instr)
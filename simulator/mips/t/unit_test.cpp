@@ -27,6 +27,35 @@ TEST( Func_instr_init, Process_Wrong_Args_Of_Constr)
  * https://github.com/awestroke/mips-dasm/blob/master/instructions_test.c
  */
 
+TEST( Func_instr_predecode, Calls_And_Returns)
+{
+    ASSERT_EQ( FuncInstr( 0x03e00008).Dump(), "jr $ra");
+    ASSERT_TRUE( FuncInstr::is_return( 0x03e00008));
+    ASSERT_FALSE( FuncInstr::is_call( 0x03e00008));
+
+    ASSERT_EQ( FuncInstr( 0x01000008).Dump(), "jr $t0");
+    ASSERT_FALSE( FuncInstr::is_return( 0x01000008));
+    ASSERT_FALSE( FuncInstr::is_call( 0x01000008));
+
+    ASSERT_EQ( FuncInstr( 0x0100f809).Dump(), "jalr $ra, $t0");
+    ASSERT_TRUE( FuncInstr::is_call( 0x0100f809));
+    ASSERT_FALSE( FuncInstr::is_return( 0x0100f809));
+
+    ASSERT_EQ( FuncInstr( 0x0c000040).Dump(), "jal 0x40");
+    ASSERT_TRUE( FuncInstr( 0x0c000040).is_call());
+    ASSERT_FALSE( FuncInstr::is_call( 0x08000040)); // j
+
+    ASSERT_TRUE( FuncInstr::is_indirect_jump( 0x03e00008));
+    ASSERT_TRUE( FuncInstr::is_indirect_jump( 0x01000008));
+    ASSERT_TRUE( FuncInstr( 0x0100f809).is_indirect_jump());
+    ASSERT_FALSE( FuncInstr::is_indirect_jump( 0x0c000040));
+
+    // jr, jalr, jal, j, beq, blez, beql, addu, lw
+    for ( uint32 raw : { 0x03e00008u, 0x0100f809u, 0x0c000040u, 0x08000040u, 0x11090004u, 0x19000004u, 0x51090004u, 0x01095021u, 0x8d090004u})
+        ASSERT_EQ( FuncInstr::is_jump( raw), FuncInstr( raw).isJump()) << std::hex << raw;
+    ASSERT_TRUE( FuncInstr::is_jump( 0x11090004));
+}
+
 #define TEST_BAD_OPCODE( opcode) \
     ASSERT_EQ(FuncInstr( opcode).Dump(), std::string(#opcode) + "\tUnknown");
 
@@ -19,6 +19,14 @@ else
 	CXXFLAGS+= -O3
 	LDFLAGS+= -flto
 endif
+# Detailed output (-d option) is compiled only in tracing builds,
+# which have their own objects and binaries
+BIN_SUFFIX:=
+ifeq ($(TRACE), 1)
+	CXXFLAGS+= -DENABLE_TRACE
+	OBJ_DIR:=$(OBJ_DIR)-trace
+	BIN_SUFFIX:=-trace
+endif
 ifeq ($(UNAME), Msys)
     CXXFLAGS+= -D__STDC_LIMIT_MACROS
     ifeq ($(CXX), clang++)